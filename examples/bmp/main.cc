@@ -58,23 +58,30 @@ void checkAgainstRawRead(byte_span bmp, const BitmapInfoHeader& infoHeader)
 auto readHeader(dualis::byte_span bmp) -> std::pair<size_t, size_t>
 {
     using namespace dualis;
-    auto const size = unpack<uint16_le>(bmp, 2);
-    auto const offset = unpack<uint32_le>(bmp, 10);
+    auto const [size, offset] =
+        unpack_tuple<expect_bytes<"BM">, uint16_le, skip<6>, uint32_le>(bmp, 0);
     return std::make_pair(size, offset);
 }
 
+// Unpacks BitmapCompression directly and knows its valid values.
+using BitmapCompressionPacking =
+    enum_packing<BitmapCompression, uint32_le, BitmapCompression::RGB, BitmapCompression::RLE4,
+                 BitmapCompression::RLE8, BitmapCompression::BitFields>;
+
+// Describes how each data member of BitmapInfoHeader is packed, in declaration order. Unpacking
+// fills the struct directly.
+using BitmapInfoHeaderPacking =
+    aggregate_packing<BitmapInfoHeader, uint32_le, int32_le, int32_le, uint16_le, uint16_le,
+                      BitmapCompressionPacking, uint32_le, int32_le, int32_le, uint32_le,
+                      uint32_le>;
+
 auto readInfoHeader(byte_stream& reader) -> BitmapInfoHeader
 {
-    BitmapInfoHeader infoHeader;
-    infoHeader.biSize = reader.unpack<uint32_le>();
-    std::tie(infoHeader.biWidth, infoHeader.biHeight) = reader.unpack_tuple<int32_le, int32_le>();
-    reader >> unpack<uint16_le>(infoHeader.biPlanes) >> unpack<uint16_le>(infoHeader.biBitCount);
-    infoHeader.biCompression = static_cast<BitmapCompression>(reader.unpack<uint32_le>());
-    infoHeader.biImageSize = reader.unpack<uint32_le>();
-    infoHeader.biXPelsPerMeter = reader.unpack<int32_le>();
-    infoHeader.biYPelsPerMeter = reader.unpack<int32_le>();
-    infoHeader.biClrUsed = reader.unpack<uint32_le>();
-    infoHeader.biClrImportant = reader.unpack<uint32_le>();
+    auto const infoHeader = reader.unpack<BitmapInfoHeaderPacking>();
+    if (!BitmapInfoHeaderPacking::is_valid(infoHeader))
+    {
+        std::cerr << "Warning: unknown compression\n";
+    }
     checkAgainstRawRead(reader.span(), infoHeader);
     return infoHeader;
 }
@@ -144,7 +151,7 @@ void printBitmapInfo(const std::filesystem::path& path)
     // byte_span does not own the memory---it's merely a convenient view.
     auto const bmpSpan = dualis::byte_span{bmp};
 
-    if (as_string_view(bmpSpan.first(2)) != "BM")
+    if (!matches<expect_bytes<"BM">>(bmpSpan, 0))
     {
         std::cerr << "Error: the given file is not a valid BMP file (wrong magic number)\n";
         std::exit(EXIT_FAILURE);
@@ -0,0 +1,369 @@
+#pragma once
+
+#include "concepts.h"
+#include "packing.h"
+#include "simd.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+
+namespace dualis {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Cyclic redundancy checks
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// The bit-reflected polynomials of CRC-32 (as used by zlib, PNG and ZIP) and of CRC-32C
+// (Castagnoli, as used by iSCSI, ext4 and SSE 4.2).
+inline constexpr uint32_t _crc32_polynomial = 0xedb88320;
+inline constexpr uint32_t _crc32c_polynomial = 0x82f63b78;
+
+// All CRC arithmetic below works on bit-reflected polynomials like the CRCs themselves: the most
+// significant bit holds the coefficient of x^0.
+
+// Multiplies a and b modulo the polynomial.
+[[nodiscard]] constexpr auto _crc_multiply(uint32_t a, uint32_t b, uint32_t polynomial) -> uint32_t
+{
+    uint32_t product = 0;
+    for (uint32_t bit = uint32_t{1} << 31; bit != 0; bit >>= 1)
+    {
+        if ((a & bit) != 0)
+        {
+            product ^= b;
+        }
+        b = (b & 1) != 0 ? (b >> 1) ^ polynomial : b >> 1;
+    }
+    return product;
+}
+
+// x^n modulo the polynomial, computed bit by bit for the folding constants.
+[[nodiscard]] constexpr auto _crc_x_pow(unsigned n, uint32_t polynomial) -> uint32_t
+{
+    uint32_t remainder = uint32_t{1} << 31;
+    for (unsigned i = 0; i < n; ++i)
+    {
+        remainder = (remainder & 1) != 0 ? (remainder >> 1) ^ polynomial : remainder >> 1;
+    }
+    return remainder;
+}
+
+[[nodiscard]] constexpr auto _reflect(uint64_t value, unsigned bits) -> uint64_t
+{
+    uint64_t reflected = 0;
+    for (unsigned i = 0; i < bits; ++i, value >>= 1)
+    {
+        reflected = (reflected << 1) | (value & 1);
+    }
+    return reflected;
+}
+
+// Tables for computing a CRC eight bytes at a time ("slicing-by-8"): table[k][b] is the CRC of
+// byte b followed by k zero bytes.
+template <uint32_t Polynomial>
+inline constexpr auto _crc_tables = [] {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        auto crc = i;
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1) != 0 ? (crc >> 1) ^ Polynomial : crc >> 1;
+        }
+        tables[0][i] = crc;
+    }
+    for (std::size_t k = 1; k < tables.size(); ++k)
+    {
+        for (std::size_t i = 0; i < 256; ++i)
+        {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xff];
+        }
+    }
+    return tables;
+}();
+
+// The kernels take and return the CRC register, i.e. the CRC before its final inversion.
+template <uint32_t Polynomial>
+[[nodiscard]] inline auto _crc_slice8(uint32_t crc, const std::byte* data, std::size_t size)
+    -> uint32_t
+{
+    auto const& t = _crc_tables<Polynomial>;
+    for (; size >= 8; size -= 8, data += 8)
+    {
+        auto const word = uint64_le::unpack(data);
+        auto const low = crc ^ static_cast<uint32_t>(word);
+        auto const high = static_cast<uint32_t>(word >> 32);
+        crc = t[7][low & 0xff] ^ t[6][(low >> 8) & 0xff] ^ t[5][(low >> 16) & 0xff] ^
+              t[4][low >> 24] ^ t[3][high & 0xff] ^ t[2][(high >> 8) & 0xff] ^
+              t[1][(high >> 16) & 0xff] ^ t[0][high >> 24];
+    }
+    for (; size > 0; --size, ++data)
+    {
+        crc = t[0][(crc ^ std::to_integer<uint32_t>(*data)) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// Combines the CRC registers of two consecutive parts as zlib does: shifting the first one by the
+// bits of the second is a multiplication by x^(8 * second_size), whose factors x^(2^k) are
+// tabulated.
+template <uint32_t Polynomial>
+[[nodiscard]] constexpr auto _crc_combine(uint32_t first, uint32_t second, std::size_t second_size)
+    -> uint32_t
+{
+    constexpr auto powers = [] {
+        std::array<uint32_t, 3 + 64> powers{};
+        powers[0] = uint32_t{1} << 30;
+        for (std::size_t k = 1; k < powers.size(); ++k)
+        {
+            powers[k] = _crc_multiply(powers[k - 1], powers[k - 1], Polynomial);
+        }
+        return powers;
+    }();
+    uint32_t shift = uint32_t{1} << 31;
+    for (std::size_t k = 3; second_size != 0; second_size >>= 1, ++k)
+    {
+        if ((second_size & 1) != 0)
+        {
+            shift = _crc_multiply(powers[k], shift, Polynomial);
+        }
+    }
+    return _crc_multiply(shift, first, Polynomial) ^ second;
+}
+
+// The constants for folding with carry-less multiplication (see Intel's "Fast CRC Computation for
+// Generic Polynomials Using PCLMULQDQ Instruction"): x^n modulo the polynomial for the distances
+// folded over, and the polynomial and its reciprocal for the final Barrett reduction, each as a
+// 33-bit reflected value.
+struct _crc_folding_constants
+{
+    uint64_t fold_4x128_low, fold_4x128_high, fold_128_low, fold_128_high, fold_64;
+    uint64_t polynomial, reciprocal;
+};
+
+[[nodiscard]] constexpr auto _make_crc_folding_constants(uint32_t polynomial)
+    -> _crc_folding_constants
+{
+    auto const fold = [&](unsigned n) { return uint64_t{_crc_x_pow(n, polynomial)} << 1; };
+    // floor(x^64 / P) by long division, with P in normal bit order.
+    auto const normal = (uint64_t{1} << 32) | _reflect(polynomial, 32);
+    uint64_t remainder = 0, quotient = 0;
+    for (int bit = 64; bit >= 0; --bit)
+    {
+        remainder = (remainder << 1) | (bit == 64 ? 1 : 0);
+        quotient <<= 1;
+        if ((remainder >> 32) != 0)
+        {
+            remainder ^= normal;
+            quotient |= 1;
+        }
+    }
+    return {fold(4 * 128 + 32), fold(4 * 128 - 32), fold(128 + 32), fold(128 - 32), fold(64),
+            _reflect(normal, 33), _reflect(quotient, 33)};
+}
+
+// The constants used by zlib for CRC-32.
+static_assert(_make_crc_folding_constants(_crc32_polynomial).fold_4x128_low == 0x154442bd4);
+static_assert(_make_crc_folding_constants(_crc32_polynomial).fold_128_high == 0x0ccaa009e);
+static_assert(_make_crc_folding_constants(_crc32_polynomial).fold_64 == 0x163cd6124);
+static_assert(_make_crc_folding_constants(_crc32_polynomial).polynomial == 0x1db710641);
+static_assert(_make_crc_folding_constants(_crc32_polynomial).reciprocal == 0x1f7011641);
+
+#ifdef _DUALIS_X86
+_DUALIS_TARGET("sse4.2")
+[[nodiscard]] inline auto _crc32c_sse42(uint32_t crc, const std::byte* data, std::size_t size)
+    -> uint32_t
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    for (; size >= 8; size -= 8, data += 8)
+    {
+        crc = static_cast<uint32_t>(_mm_crc32_u64(crc, uint64_le::unpack(data)));
+    }
+#endif
+    for (; size >= 4; size -= 4, data += 4)
+    {
+        crc = _mm_crc32_u32(crc, uint32_le::unpack(data));
+    }
+    for (; size > 0; --size, ++data)
+    {
+        crc = _mm_crc32_u8(crc, std::to_integer<uint8_t>(*data));
+    }
+    return crc;
+}
+
+// Multiplies the low and the high half of x by those of k and adds both products to next.
+_DUALIS_TARGET("sse4.2,pclmul")
+[[nodiscard]] inline auto _crc_fold(__m128i x, __m128i k, __m128i next) -> __m128i
+{
+    return _mm_xor_si128(
+        _mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x00), _mm_clmulepi64_si128(x, k, 0x11)), next);
+}
+
+// Folds four 128-bit lanes over each 64 bytes, then the lanes into one and that over each further
+// 16 bytes, and reduces the result to 32 bits. Inputs shorter than 64 bytes and the bytes after
+// the last whole 16 are processed by the table (or, for CRC-32C, the crc32 instruction).
+template <uint32_t Polynomial>
+_DUALIS_TARGET("sse4.2,pclmul")
+[[nodiscard]] auto _crc_fold_pclmul(uint32_t crc, const std::byte* data, std::size_t size)
+    -> uint32_t
+{
+    auto const tail = [](uint32_t crc, const std::byte* data, std::size_t size) {
+        if constexpr (Polynomial == _crc32c_polynomial)
+        {
+            return _crc32c_sse42(crc, data, size);
+        }
+        else
+        {
+            return _crc_slice8<Polynomial>(crc, data, size);
+        }
+    };
+    if (size < 64)
+    {
+        return tail(crc, data, size);
+    }
+
+    constexpr auto c = _make_crc_folding_constants(Polynomial);
+    auto const* blocks = reinterpret_cast<const __m128i*>(data);
+
+    auto x1 = _mm_xor_si128(_mm_loadu_si128(blocks), _mm_cvtsi32_si128(static_cast<int>(crc)));
+    auto x2 = _mm_loadu_si128(blocks + 1);
+    auto x3 = _mm_loadu_si128(blocks + 2);
+    auto x4 = _mm_loadu_si128(blocks + 3);
+    blocks += 4;
+    size -= 64;
+
+    auto k = _mm_set_epi64x(static_cast<int64_t>(c.fold_4x128_high),
+                            static_cast<int64_t>(c.fold_4x128_low));
+    for (; size >= 64; size -= 64, blocks += 4)
+    {
+        x1 = _crc_fold(x1, k, _mm_loadu_si128(blocks));
+        x2 = _crc_fold(x2, k, _mm_loadu_si128(blocks + 1));
+        x3 = _crc_fold(x3, k, _mm_loadu_si128(blocks + 2));
+        x4 = _crc_fold(x4, k, _mm_loadu_si128(blocks + 3));
+    }
+
+    k = _mm_set_epi64x(static_cast<int64_t>(c.fold_128_high), static_cast<int64_t>(c.fold_128_low));
+    x1 = _crc_fold(x1, k, x2);
+    x1 = _crc_fold(x1, k, x3);
+    x1 = _crc_fold(x1, k, x4);
+    for (; size >= 16; size -= 16, ++blocks)
+    {
+        x1 = _crc_fold(x1, k, _mm_loadu_si128(blocks));
+    }
+
+    // Folds 128 bits into 64.
+    auto const low_words = _mm_setr_epi32(-1, 0, -1, 0);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), _mm_clmulepi64_si128(x1, k, 0x10));
+    k = _mm_set_epi64x(0, static_cast<int64_t>(c.fold_64));
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, low_words), k, 0x00),
+                       _mm_srli_si128(x1, 4));
+
+    // Barrett reduction to 32 bits.
+    k = _mm_set_epi64x(static_cast<int64_t>(c.reciprocal), static_cast<int64_t>(c.polynomial));
+    auto t = _mm_clmulepi64_si128(_mm_and_si128(x1, low_words), k, 0x10);
+    t = _mm_clmulepi64_si128(_mm_and_si128(t, low_words), k, 0x00);
+    crc = static_cast<uint32_t>(_mm_extract_epi32(_mm_xor_si128(x1, t), 1));
+
+    return tail(crc, reinterpret_cast<const std::byte*>(blocks), size);
+}
+#endif
+
+using _crc_kernel = uint32_t (*)(uint32_t, const std::byte*, std::size_t);
+
+struct _crc_kernels
+{
+    _crc_kernel crc32 = _crc_slice8<_crc32_polynomial>;
+    _crc_kernel crc32c = _crc_slice8<_crc32c_polynomial>;
+};
+
+// Builds the table of the best kernels available given whether the CPU supports the SSE 4.2 crc32
+// instruction and carry-less multiplication. Exposed so that every variant can be tested.
+[[nodiscard]] inline auto _make_crc_kernels([[maybe_unused]] bool sse42,
+                                            [[maybe_unused]] bool pclmul) -> _crc_kernels
+{
+    _crc_kernels kernels;
+#ifdef _DUALIS_X86
+    if (sse42 && pclmul)
+    {
+        kernels.crc32 = _crc_fold_pclmul<_crc32_polynomial>;
+        kernels.crc32c = _crc_fold_pclmul<_crc32c_polynomial>;
+    }
+    else if (sse42)
+    {
+        kernels.crc32c = _crc32c_sse42;
+    }
+#endif
+    return kernels;
+}
+
+// Queries the CPU for the SSE 4.2 crc32 instruction and carry-less multiplication.
+[[nodiscard]] inline auto _detect_crc_support() -> std::pair<bool, bool>
+{
+#if defined(_DUALIS_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    return {__builtin_cpu_supports("sse4.2") != 0, __builtin_cpu_supports("pclmul") != 0};
+#elif defined(_DUALIS_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return {(info[2] & (1 << 20)) != 0, (info[2] & (1 << 1)) != 0};
+#else
+    return {false, false};
+#endif
+}
+
+// The kernels are selected once, on first use, based on the CPU the program runs on.
+[[nodiscard]] inline auto _active_crc_kernels() -> const _crc_kernels&
+{
+    static const _crc_kernels kernels = [] {
+        auto const [sse42, pclmul] = _detect_crc_support();
+        return _make_crc_kernels(sse42, pclmul);
+    }();
+    return kernels;
+}
+
+} // namespace detail
+
+// Computes the CRC-32 of size bytes at data, as zlib, PNG and ZIP do. To continue the checksum of
+// preceding bytes (e.g. when the data arrives in parts), pass that checksum as crc.
+[[nodiscard]] inline auto crc32(const std::byte* data, std::size_t size, uint32_t crc = 0)
+    -> uint32_t
+{
+    return ~detail::_active_crc_kernels().crc32(~crc, data, size);
+}
+
+template <byte_range Bytes>
+[[nodiscard]] auto crc32(const Bytes& bytes, uint32_t crc = 0) -> uint32_t
+{
+    return crc32(std::ranges::cdata(bytes), std::ranges::size(bytes), crc);
+}
+
+// Computes the CRC-32C (Castagnoli) of size bytes at data, continuing crc like crc32.
+[[nodiscard]] inline auto crc32c(const std::byte* data, std::size_t size, uint32_t crc = 0)
+    -> uint32_t
+{
+    return ~detail::_active_crc_kernels().crc32c(~crc, data, size);
+}
+
+template <byte_range Bytes>
+[[nodiscard]] auto crc32c(const Bytes& bytes, uint32_t crc = 0) -> uint32_t
+{
+    return crc32c(std::ranges::cdata(bytes), std::ranges::size(bytes), crc);
+}
+
+// Given the checksums of two consecutive parts and the size of the second one, returns the
+// checksum of both, so that the parts can be checksummed independently (e.g. in parallel).
+[[nodiscard]] constexpr auto crc32_combine(uint32_t first, uint32_t second,
+                                           std::size_t second_size) -> uint32_t
+{
+    return detail::_crc_combine<detail::_crc32_polynomial>(first, second, second_size);
+}
+
+[[nodiscard]] constexpr auto crc32c_combine(uint32_t first, uint32_t second,
+                                            std::size_t second_size) -> uint32_t
+{
+    return detail::_crc_combine<detail::_crc32c_polynomial>(first, second, second_size);
+}
+
+} // namespace dualis
@@ -37,6 +37,64 @@ concept byte_packing = requires(const std::byte* bytes,
     { T::size() } -> std::same_as<std::size_t>;
     T::pack(writable_bytes, value);
 };
+
+// A bulk_byte_packing additionally packs or unpacks a contiguous array of values at once, which
+// allows for vectorized implementations. The functions using a packing prefer these methods over
+// repeated calls to pack and unpack when the values are stored contiguously.
+template<class T>
+concept bulk_byte_packing = byte_packing<T> &&
+                            requires(const std::byte* bytes,
+                                     std::byte* writable_bytes,
+                                     typename T::value_type* values,
+                                     const typename T::value_type* const_values,
+                                     std::size_t count)
+{
+    T::unpack_range(bytes, values, count);
+    T::pack_range(writable_bytes, const_values, count);
+};
+
+// A validating_byte_packing additionally tells whether an unpacked value is valid (for example, a
+// known enumerator). The checked unpacking functions reject invalid values.
+template<class T>
+concept validating_byte_packing = byte_packing<T> &&
+                                  requires(const typename T::value_type& value)
+{
+    { T::is_valid(value) } -> std::same_as<bool>;
+};
+
+// A variable_byte_packing describes a packing whose size depends on the packed value, such as a
+// variable-length integer. unpack additionally reports how many bytes it consumed, size returns how
+// many bytes packing the given value takes, and pack returns how many bytes it wrote.
+template<class T>
+concept variable_byte_packing = requires(const std::byte* bytes,
+                                         std::byte* writable_bytes,
+                                         const typename T::value_type& value,
+                                         std::size_t& size)
+{
+    typename T::value_type;
+    { T::unpack(bytes, size) } -> std::same_as<typename T::value_type>;
+    { T::size(value) } -> std::same_as<std::size_t>;
+    { T::pack(writable_bytes, value) } -> std::same_as<std::size_t>;
+};
+
+// A pseudo_packing occupies bytes without holding a value, such as reserved bytes or padding. Its
+// size may depend on the offset at which it is placed, and pack writes its bytes at that offset.
+// Tuple packings omit pseudo packings from their values.
+template<class T>
+concept pseudo_packing = requires(std::byte* writable_bytes, std::size_t offset)
+{
+    { T::size(offset) } -> std::same_as<std::size_t>;
+    T::pack(writable_bytes, offset);
+};
+
+// A signature_packing is a pseudo_packing of constant bytes, such as a magic number. matches tells
+// whether the given bytes equal them; checked unpacking rejects bytes that do not.
+template<class T>
+concept signature_packing = pseudo_packing<T> && requires(const std::byte* bytes)
+{
+    { std::ranges::data(T::signature) } -> std::convertible_to<const std::byte*>;
+    { T::matches(bytes) } -> std::same_as<bool>;
+};
 // clang-format on
 
 } // namespace dualis
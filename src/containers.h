@@ -1354,6 +1354,14 @@ public:
         return *this;
     }
 
+    template <variable_byte_packing Packing>
+    constexpr auto append_packed(const typename Packing::value_type& value) -> byte_container&
+    {
+        m_storage.append(Packing::size(value),
+                         [&value](std::byte* dest) { Packing::pack(dest, value); });
+        return *this;
+    }
+
     // Convenience method for appending packed tuples. This overload is declared for at least two
     // values because otherwise, append_packed would become ambiguous for one value.
     template <byte_packing Packing, byte_packing Packing2, byte_packing... Packings>
@@ -4,13 +4,8 @@ constexpr auto byte_container<Allocator, EmbeddedSize>::insert_packed_range(size
                                                                             const Range& range)
     -> byte_container&
 {
-    m_storage.insert(offset, Packing::size() * std::ranges::size(range), [&range](std::byte* dest) {
-        for (auto const& value : range)
-        {
-            Packing::pack(dest, value);
-            dest += Packing::size();
-        }
-    });
+    m_storage.insert(offset, Packing::size() * std::ranges::size(range),
+                     [&range](std::byte* dest) { detail::_pack_all<Packing>(dest, range); });
     return *this;
 }
 
@@ -20,13 +15,7 @@ constexpr auto byte_container<Allocator, EmbeddedSize>::append_packed_range(cons
     -> byte_container&
 {
     const auto size = Packing::size() * std::ranges::size(range);
-    m_storage.append(size, [&range](std::byte* dest) {
-        for (auto const& value : range)
-        {
-            Packing::pack(dest, value);
-            dest += Packing::size();
-        }
-    });
+    m_storage.append(size, [&range](std::byte* dest) { detail::_pack_all<Packing>(dest, range); });
     return *this;
 }
 
@@ -5,8 +5,16 @@
 
 #include "concepts.h"
 #include "utilities.h"
+#include "simd.h"
 #include "containers.h"
 #include "packing.h"
+#include "varint.h"
+#include "views.h"
+#include "layout.h"
+#include "variant.h"
+#include "parallel.h"
+#include "checksum.h"
+#include "hash.h"
 #include "streams.h"
 
 #include <bit>
@@ -0,0 +1,616 @@
+#pragma once
+
+#include "concepts.h"
+#include "containers.h"
+#include "packing.h"
+#include "simd.h"
+#include "utilities.h"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ranges>
+
+namespace dualis {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Hashing
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// A 128-bit hash.
+struct hash128
+{
+    uint64_t low;
+    uint64_t high;
+
+    [[nodiscard]] constexpr bool operator==(const hash128& rhs) const noexcept = default;
+};
+
+namespace detail {
+
+// The constants of XXH3 (see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md).
+inline constexpr uint64_t _xxh_prime32_1 = 0x9e3779b1;
+inline constexpr uint64_t _xxh_prime32_2 = 0x85ebca77;
+inline constexpr uint64_t _xxh_prime32_3 = 0xc2b2ae3d;
+inline constexpr uint64_t _xxh_prime64_1 = 0x9e3779b185ebca87;
+inline constexpr uint64_t _xxh_prime64_2 = 0xc2b2ae3d27d4eb4f;
+inline constexpr uint64_t _xxh_prime64_3 = 0x165667b19e3779f9;
+inline constexpr uint64_t _xxh_prime64_4 = 0x85ebca77c2b2ae63;
+inline constexpr uint64_t _xxh_prime64_5 = 0x27d4eb2f165667c5;
+inline constexpr uint64_t _xxh_prime_mx1 = 0x165667919e3779f9;
+inline constexpr uint64_t _xxh_prime_mx2 = 0x9fb21c651e98df25;
+
+// The default secret, which the seed is mixed into.
+inline constexpr std::size_t _xxh3_secret_size = 192;
+alignas(64) inline constexpr auto _xxh3_secret = [] {
+    constexpr uint8_t secret[_xxh3_secret_size] = {
+        0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad,
+        0x1c, 0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3,
+        0x67, 0x1f, 0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc,
+        0xff, 0x72, 0x21, 0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6,
+        0x81, 0x3a, 0x26, 0x4c, 0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65,
+        0x8b, 0x1b, 0x53, 0x2e, 0xa3, 0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19,
+        0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8, 0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9,
+        0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d, 0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31,
+        0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64, 0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb,
+        0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb, 0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0,
+        0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e, 0x2b, 0x16, 0xbe, 0x58, 0x7d,
+        0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce, 0x45, 0xcb, 0x3a, 0x8f,
+        0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+    };
+    std::array<std::byte, _xxh3_secret_size> bytes{};
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = std::byte{secret[i]};
+    }
+    return bytes;
+}();
+
+#if defined(__SIZEOF_INT128__)
+__extension__ using _uint128 = unsigned __int128;
+#endif
+
+// The full 128-bit product of a and b.
+[[nodiscard]] inline auto _multiply_128(uint64_t a, uint64_t b) -> hash128
+{
+#if defined(__SIZEOF_INT128__)
+    auto const product = _uint128{a} * b;
+    return {static_cast<uint64_t>(product), static_cast<uint64_t>(product >> 64)};
+#elif defined(_MSC_VER) && defined(_M_X64)
+    uint64_t high;
+    auto const low = _umul128(a, b, &high);
+    return {low, high};
+#else
+    auto const lo_lo = (a & 0xffffffff) * (b & 0xffffffff);
+    auto const hi_lo = (a >> 32) * (b & 0xffffffff);
+    auto const lo_hi = (a & 0xffffffff) * (b >> 32);
+    auto const hi_hi = (a >> 32) * (b >> 32);
+    auto const cross = (lo_lo >> 32) + (hi_lo & 0xffffffff) + lo_hi;
+    return {(cross << 32) | (lo_lo & 0xffffffff), (hi_lo >> 32) + (cross >> 32) + hi_hi};
+#endif
+}
+
+[[nodiscard]] inline auto _multiply_fold_64(uint64_t a, uint64_t b) -> uint64_t
+{
+    auto const product = _multiply_128(a, b);
+    return product.low ^ product.high;
+}
+
+[[nodiscard]] constexpr auto _xxh64_avalanche(uint64_t h) -> uint64_t
+{
+    h ^= h >> 33;
+    h *= _xxh_prime64_2;
+    h ^= h >> 29;
+    h *= _xxh_prime64_3;
+    return h ^ (h >> 32);
+}
+
+[[nodiscard]] constexpr auto _xxh3_avalanche(uint64_t h) -> uint64_t
+{
+    h ^= h >> 37;
+    h *= _xxh_prime_mx1;
+    return h ^ (h >> 32);
+}
+
+[[nodiscard]] constexpr auto _xxh3_rrmxmx(uint64_t h, std::size_t size) -> uint64_t
+{
+    h ^= std::rotl(h, 49) ^ std::rotl(h, 24);
+    h *= _xxh_prime_mx2;
+    h ^= (h >> 35) + size;
+    h *= _xxh_prime_mx2;
+    return h ^ (h >> 28);
+}
+
+[[nodiscard]] inline auto _xxh3_mix_16(const std::byte* data, const std::byte* secret,
+                                       uint64_t seed) -> uint64_t
+{
+    return _multiply_fold_64(uint64_le::unpack(data) ^ (uint64_le::unpack(secret) + seed),
+                             uint64_le::unpack(data + 8) ^ (uint64_le::unpack(secret + 8) - seed));
+}
+
+// Mixes 16 bytes from each end of a range into the two halves of acc.
+[[nodiscard]] inline auto _xxh3_mix_32(hash128 acc, const std::byte* first,
+                                       const std::byte* second, const std::byte* secret,
+                                       uint64_t seed) -> hash128
+{
+    acc.low += _xxh3_mix_16(first, secret, seed);
+    acc.low ^= uint64_le::unpack(second) + uint64_le::unpack(second + 8);
+    acc.high += _xxh3_mix_16(second, secret + 16, seed);
+    acc.high ^= uint64_le::unpack(first) + uint64_le::unpack(first + 8);
+    return acc;
+}
+
+//== long inputs ==================================================================================
+
+// Inputs longer than 240 bytes are consumed in stripes of 64 bytes by eight 64-bit accumulators,
+// which are scrambled after each block of 16 stripes. This is the only part worth vectorizing: the
+// kernels accumulate a number of consecutive stripes, advancing through the secret by 8 bytes per
+// stripe.
+inline constexpr std::size_t _xxh3_stripe_size = 64;
+inline constexpr std::size_t _xxh3_block_stripes = (_xxh3_secret_size - _xxh3_stripe_size) / 8;
+
+inline void _xxh3_accumulate_scalar(uint64_t* acc, const std::byte* data, const std::byte* secret,
+                                    std::size_t stripes)
+{
+    for (std::size_t n = 0; n < stripes; ++n, data += _xxh3_stripe_size, secret += 8)
+    {
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            auto const value = uint64_le::unpack(data + 8 * i);
+            auto const key = value ^ uint64_le::unpack(secret + 8 * i);
+            acc[i ^ 1] += value;
+            acc[i] += (key & 0xffffffff) * (key >> 32);
+        }
+    }
+}
+
+inline void _xxh3_scramble_scalar(uint64_t* acc, const std::byte* secret)
+{
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        acc[i] = (acc[i] ^ (acc[i] >> 47) ^ uint64_le::unpack(secret + 8 * i)) * _xxh_prime32_1;
+    }
+}
+
+#ifdef _DUALIS_X86
+_DUALIS_TARGET("sse2")
+inline void _xxh3_accumulate_sse2(uint64_t* acc, const std::byte* data, const std::byte* secret,
+                                  std::size_t stripes)
+{
+    auto* const lanes = reinterpret_cast<__m128i*>(acc);
+    __m128i sums[4];
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        sums[i] = _mm_loadu_si128(lanes + i);
+    }
+    for (std::size_t n = 0; n < stripes; ++n, data += _xxh3_stripe_size, secret += 8)
+    {
+        for (std::size_t i = 0; i < 4; ++i)
+        {
+            auto const value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data) + i);
+            auto const key = _mm_xor_si128(
+                value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+            auto const product = _mm_mul_epu32(key, _mm_srli_epi64(key, 32));
+            auto const swapped = _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+            sums[i] = _mm_add_epi64(sums[i], _mm_add_epi64(product, swapped));
+        }
+    }
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        _mm_storeu_si128(lanes + i, sums[i]);
+    }
+}
+
+_DUALIS_TARGET("sse2")
+inline void _xxh3_scramble_sse2(uint64_t* acc, const std::byte* secret)
+{
+    auto* const lanes = reinterpret_cast<__m128i*>(acc);
+    auto const prime = _mm_set1_epi32(static_cast<int>(_xxh_prime32_1));
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        auto lane = _mm_loadu_si128(lanes + i);
+        lane = _mm_xor_si128(lane, _mm_srli_epi64(lane, 47));
+        lane = _mm_xor_si128(lane, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+        auto const low = _mm_mul_epu32(lane, prime);
+        auto const high = _mm_mul_epu32(_mm_srli_epi64(lane, 32), prime);
+        _mm_storeu_si128(lanes + i, _mm_add_epi64(low, _mm_slli_epi64(high, 32)));
+    }
+}
+
+_DUALIS_TARGET("avx2")
+inline void _xxh3_accumulate_avx2(uint64_t* acc, const std::byte* data, const std::byte* secret,
+                                  std::size_t stripes)
+{
+    auto* const lanes = reinterpret_cast<__m256i*>(acc);
+    __m256i sums[2] = {_mm256_loadu_si256(lanes), _mm256_loadu_si256(lanes + 1)};
+    for (std::size_t n = 0; n < stripes; ++n, data += _xxh3_stripe_size, secret += 8)
+    {
+        for (std::size_t i = 0; i < 2; ++i)
+        {
+            auto const value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data) + i);
+            auto const key = _mm256_xor_si256(
+                value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i));
+            auto const product = _mm256_mul_epu32(key, _mm256_srli_epi64(key, 32));
+            auto const swapped = _mm256_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2));
+            sums[i] = _mm256_add_epi64(sums[i], _mm256_add_epi64(product, swapped));
+        }
+    }
+    _mm256_storeu_si256(lanes, sums[0]);
+    _mm256_storeu_si256(lanes + 1, sums[1]);
+}
+
+_DUALIS_TARGET("avx2")
+inline void _xxh3_scramble_avx2(uint64_t* acc, const std::byte* secret)
+{
+    auto* const lanes = reinterpret_cast<__m256i*>(acc);
+    auto const prime = _mm256_set1_epi32(static_cast<int>(_xxh_prime32_1));
+    for (std::size_t i = 0; i < 2; ++i)
+    {
+        auto lane = _mm256_loadu_si256(lanes + i);
+        lane = _mm256_xor_si256(lane, _mm256_srli_epi64(lane, 47));
+        lane = _mm256_xor_si256(
+            lane, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i));
+        auto const low = _mm256_mul_epu32(lane, prime);
+        auto const high = _mm256_mul_epu32(_mm256_srli_epi64(lane, 32), prime);
+        _mm256_storeu_si256(lanes + i, _mm256_add_epi64(low, _mm256_slli_epi64(high, 32)));
+    }
+}
+#endif
+
+struct _hash_kernels
+{
+    simd_level level{simd_level::scalar};
+    void (*accumulate)(uint64_t*, const std::byte*, const std::byte*, std::size_t){
+        _xxh3_accumulate_scalar};
+    void (*scramble)(uint64_t*, const std::byte*){_xxh3_scramble_scalar};
+};
+
+// Builds the table of the best kernels available for the given level. Exposed so that every
+// variant can be tested.
+[[nodiscard]] inline auto _make_hash_kernels(simd_level level) -> _hash_kernels
+{
+    _hash_kernels kernels;
+    kernels.level = level;
+#ifdef _DUALIS_X86
+    switch (level)
+    {
+    // AVX-512 gains little over AVX2, as the accumulation is bound by the memory bandwidth.
+    case simd_level::avx512:
+    case simd_level::avx2:
+        kernels.accumulate = _xxh3_accumulate_avx2;
+        kernels.scramble = _xxh3_scramble_avx2;
+        break;
+    case simd_level::ssse3:
+    case simd_level::sse2:
+        kernels.accumulate = _xxh3_accumulate_sse2;
+        kernels.scramble = _xxh3_scramble_sse2;
+        break;
+    default: break;
+    }
+#else
+    kernels.level = simd_level::scalar;
+#endif
+    return kernels;
+}
+
+// The kernels are selected once, on first use, based on the CPU the program runs on.
+[[nodiscard]] inline auto _active_hash_kernels() -> const _hash_kernels&
+{
+    static const _hash_kernels kernels = _make_hash_kernels(detect_simd_level());
+    return kernels;
+}
+
+// Runs the accumulators over all stripes of size (more than 240) bytes at data; the last stripe
+// is always the last 64 bytes, overlapping the previous one.
+inline void _xxh3_accumulate_long(const _hash_kernels& kernels, std::array<uint64_t, 8>& acc,
+                                  const std::byte* data, std::size_t size, const std::byte* secret)
+{
+    constexpr auto block_size = _xxh3_stripe_size * _xxh3_block_stripes;
+    auto const blocks = (size - 1) / block_size;
+    for (std::size_t n = 0; n < blocks; ++n)
+    {
+        kernels.accumulate(acc.data(), data + n * block_size, secret, _xxh3_block_stripes);
+        kernels.scramble(acc.data(), secret + _xxh3_secret_size - _xxh3_stripe_size);
+    }
+    auto const stripes = ((size - 1) - blocks * block_size) / _xxh3_stripe_size;
+    kernels.accumulate(acc.data(), data + blocks * block_size, secret, stripes);
+    kernels.accumulate(acc.data(), data + size - _xxh3_stripe_size,
+                       secret + _xxh3_secret_size - _xxh3_stripe_size - 7, 1);
+}
+
+[[nodiscard]] inline auto _xxh3_merge(const std::array<uint64_t, 8>& acc, const std::byte* secret,
+                                      uint64_t start) -> uint64_t
+{
+    for (std::size_t i = 0; i < 4; ++i)
+    {
+        start += _multiply_fold_64(acc[2 * i] ^ uint64_le::unpack(secret + 16 * i),
+                                   acc[2 * i + 1] ^ uint64_le::unpack(secret + 16 * i + 8));
+    }
+    return _xxh3_avalanche(start);
+}
+
+// A seed other than 0 is mixed into the secret for long inputs, rather than into each step.
+[[nodiscard]] inline auto _xxh3_seeded_secret(uint64_t seed)
+    -> std::array<std::byte, _xxh3_secret_size>
+{
+    std::array<std::byte, _xxh3_secret_size> secret;
+    for (std::size_t i = 0; i < secret.size(); i += 16)
+    {
+        uint64_le::pack(secret.data() + i, uint64_le::unpack(_xxh3_secret.data() + i) + seed);
+        uint64_le::pack(secret.data() + i + 8,
+                        uint64_le::unpack(_xxh3_secret.data() + i + 8) - seed);
+    }
+    return secret;
+}
+
+inline constexpr std::array<uint64_t, 8> _xxh3_initial_acc{
+    _xxh_prime32_3, _xxh_prime64_1, _xxh_prime64_2, _xxh_prime64_3,
+    _xxh_prime64_4, _xxh_prime32_2, _xxh_prime64_5, _xxh_prime32_1};
+
+//== 64-bit hash ==================================================================================
+
+[[nodiscard]] inline auto _xxh3_64_short(const std::byte* data, std::size_t size, uint64_t seed)
+    -> uint64_t
+{
+    auto const* secret = _xxh3_secret.data();
+    if (size > 8)
+    {
+        auto const low_flip =
+            (uint64_le::unpack(secret + 24) ^ uint64_le::unpack(secret + 32)) + seed;
+        auto const high_flip =
+            (uint64_le::unpack(secret + 40) ^ uint64_le::unpack(secret + 48)) - seed;
+        auto const low = uint64_le::unpack(data) ^ low_flip;
+        auto const high = uint64_le::unpack(data + size - 8) ^ high_flip;
+        return _xxh3_avalanche(size + byte_swap(low) + high + _multiply_fold_64(low, high));
+    }
+    if (size >= 4)
+    {
+        seed ^= uint64_t{byte_swap(static_cast<uint32_t>(seed))} << 32;
+        auto const value = uint32_le::unpack(data + size - 4) +
+                           (uint64_t{uint32_le::unpack(data)} << 32);
+        auto const flip = (uint64_le::unpack(secret + 8) ^ uint64_le::unpack(secret + 16)) - seed;
+        return _xxh3_rrmxmx(value ^ flip, size);
+    }
+    if (size > 0)
+    {
+        auto const combined = (std::to_integer<uint32_t>(data[0]) << 16) |
+                              (std::to_integer<uint32_t>(data[size >> 1]) << 24) |
+                              std::to_integer<uint32_t>(data[size - 1]) |
+                              (static_cast<uint32_t>(size) << 8);
+        auto const flip = (uint32_le::unpack(secret) ^ uint32_le::unpack(secret + 4)) + seed;
+        return _xxh64_avalanche(combined ^ flip);
+    }
+    return _xxh64_avalanche(seed ^ uint64_le::unpack(secret + 56) ^ uint64_le::unpack(secret + 64));
+}
+
+[[nodiscard]] inline auto _xxh3_64_medium(const std::byte* data, std::size_t size, uint64_t seed)
+    -> uint64_t
+{
+    auto const* secret = _xxh3_secret.data();
+    uint64_t acc = size * _xxh_prime64_1;
+    if (size <= 128)
+    {
+        // Mixes pairs of 16 bytes from both ends towards the middle.
+        for (std::size_t i = 0; i <= (size - 1) / 32; ++i)
+        {
+            acc += _xxh3_mix_16(data + 16 * i, secret + 32 * i, seed);
+            acc += _xxh3_mix_16(data + size - 16 * (i + 1), secret + 32 * i + 16, seed);
+        }
+        return _xxh3_avalanche(acc);
+    }
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        acc += _xxh3_mix_16(data + 16 * i, secret + 16 * i, seed);
+    }
+    auto end = _xxh3_mix_16(data + size - 16, secret + 136 - 17, seed);
+    for (std::size_t i = 8; i < size / 16; ++i)
+    {
+        end += _xxh3_mix_16(data + 16 * i, secret + 16 * (i - 8) + 3, seed);
+    }
+    return _xxh3_avalanche(_xxh3_avalanche(acc) + end);
+}
+
+[[nodiscard]] inline auto _xxh3_64_long(const std::byte* data, std::size_t size,
+                                        const std::byte* secret) -> uint64_t
+{
+    auto acc = _xxh3_initial_acc;
+    _xxh3_accumulate_long(_active_hash_kernels(), acc, data, size, secret);
+    return _xxh3_merge(acc, secret + 11, size * _xxh_prime64_1);
+}
+
+//== 128-bit hash =================================================================================
+
+[[nodiscard]] inline auto _xxh3_128_short(const std::byte* data, std::size_t size, uint64_t seed)
+    -> hash128
+{
+    auto const* secret = _xxh3_secret.data();
+    if (size > 8)
+    {
+        auto const low_flip =
+            (uint64_le::unpack(secret + 32) ^ uint64_le::unpack(secret + 40)) - seed;
+        auto const high_flip =
+            (uint64_le::unpack(secret + 48) ^ uint64_le::unpack(secret + 56)) + seed;
+        auto const low = uint64_le::unpack(data);
+        auto high = uint64_le::unpack(data + size - 8);
+        auto m = _multiply_128(low ^ high ^ low_flip, _xxh_prime64_1);
+        m.low += uint64_t{size - 1} << 54;
+        high ^= high_flip;
+        m.high += high + (high & 0xffffffff) * (_xxh_prime32_2 - 1);
+        m.low ^= byte_swap(m.high);
+        auto h = _multiply_128(m.low, _xxh_prime64_2);
+        h.high += m.high * _xxh_prime64_2;
+        return {_xxh3_avalanche(h.low), _xxh3_avalanche(h.high)};
+    }
+    if (size >= 4)
+    {
+        seed ^= uint64_t{byte_swap(static_cast<uint32_t>(seed))} << 32;
+        auto const value = uint32_le::unpack(data) +
+                           (uint64_t{uint32_le::unpack(data + size - 4)} << 32);
+        auto const key =
+            value ^ ((uint64_le::unpack(secret + 16) ^ uint64_le::unpack(secret + 24)) + seed);
+        auto m = _multiply_128(key, _xxh_prime64_1 + (size << 2));
+        m.high += m.low << 1;
+        m.low ^= m.high >> 3;
+        m.low ^= m.low >> 35;
+        m.low *= _xxh_prime_mx2;
+        m.low ^= m.low >> 28;
+        return {m.low, _xxh3_avalanche(m.high)};
+    }
+    if (size > 0)
+    {
+        auto const low = (std::to_integer<uint32_t>(data[0]) << 16) |
+                         (std::to_integer<uint32_t>(data[size >> 1]) << 24) |
+                         std::to_integer<uint32_t>(data[size - 1]) |
+                         (static_cast<uint32_t>(size) << 8);
+        auto const high = std::rotl(byte_swap(low), 13);
+        auto const low_flip = (uint32_le::unpack(secret) ^ uint32_le::unpack(secret + 4)) + seed;
+        auto const high_flip =
+            (uint32_le::unpack(secret + 8) ^ uint32_le::unpack(secret + 12)) - seed;
+        return {_xxh64_avalanche(low ^ low_flip), _xxh64_avalanche(high ^ high_flip)};
+    }
+    auto const low_flip = uint64_le::unpack(secret + 64) ^ uint64_le::unpack(secret + 72);
+    auto const high_flip = uint64_le::unpack(secret + 80) ^ uint64_le::unpack(secret + 88);
+    return {_xxh64_avalanche(seed ^ low_flip), _xxh64_avalanche(seed ^ high_flip)};
+}
+
+[[nodiscard]] inline auto _xxh3_128_medium(const std::byte* data, std::size_t size, uint64_t seed)
+    -> hash128
+{
+    auto const* secret = _xxh3_secret.data();
+    hash128 acc{size * _xxh_prime64_1, 0};
+    if (size <= 128)
+    {
+        for (auto i = (size - 1) / 32 + 1; i-- > 0;)
+        {
+            acc = _xxh3_mix_32(acc, data + 16 * i, data + size - 16 * (i + 1), secret + 32 * i,
+                               seed);
+        }
+    }
+    else
+    {
+        for (std::size_t i = 32; i < 160; i += 32)
+        {
+            acc = _xxh3_mix_32(acc, data + i - 32, data + i - 16, secret + i - 32, seed);
+        }
+        acc = {_xxh3_avalanche(acc.low), _xxh3_avalanche(acc.high)};
+        for (std::size_t i = 160; i <= size; i += 32)
+        {
+            acc = _xxh3_mix_32(acc, data + i - 32, data + i - 16, secret + 3 + i - 160, seed);
+        }
+        acc = _xxh3_mix_32(acc, data + size - 16, data + size - 32, secret + 136 - 17 - 16,
+                           0 - seed);
+    }
+    return {_xxh3_avalanche(acc.low + acc.high),
+            0 - _xxh3_avalanche(acc.low * _xxh_prime64_1 + acc.high * _xxh_prime64_4 +
+                                (size - seed) * _xxh_prime64_2)};
+}
+
+[[nodiscard]] inline auto _xxh3_128_long(const std::byte* data, std::size_t size,
+                                         const std::byte* secret) -> hash128
+{
+    auto acc = _xxh3_initial_acc;
+    _xxh3_accumulate_long(_active_hash_kernels(), acc, data, size, secret);
+    return {_xxh3_merge(acc, secret + 11, size * _xxh_prime64_1),
+            _xxh3_merge(acc, secret + _xxh3_secret_size - _xxh3_stripe_size - 11,
+                        ~(size * _xxh_prime64_2))};
+}
+
+} // namespace detail
+
+// Computes the 64-bit XXH3 hash of size bytes at data. Like all non-cryptographic hashes, it is
+// meant for hash tables, deduplication and the like, not to withstand deliberate collisions; a
+// random seed makes those harder to find, though.
+[[nodiscard]] inline auto xxh3_64(const std::byte* data, std::size_t size, uint64_t seed = 0)
+    -> uint64_t
+{
+    if (size <= 16)
+    {
+        return detail::_xxh3_64_short(data, size, seed);
+    }
+    if (size <= 240)
+    {
+        return detail::_xxh3_64_medium(data, size, seed);
+    }
+    if (seed == 0)
+    {
+        return detail::_xxh3_64_long(data, size, detail::_xxh3_secret.data());
+    }
+    return detail::_xxh3_64_long(data, size, detail::_xxh3_seeded_secret(seed).data());
+}
+
+template <byte_range Bytes>
+[[nodiscard]] auto xxh3_64(const Bytes& bytes, uint64_t seed = 0) -> uint64_t
+{
+    return xxh3_64(std::ranges::cdata(bytes), std::ranges::size(bytes), seed);
+}
+
+// Computes the 128-bit XXH3 hash of size bytes at data, for when 64 bits make collisions too
+// likely, e.g. when identifying billions of distinct byte strings by their hashes.
+[[nodiscard]] inline auto xxh3_128(const std::byte* data, std::size_t size, uint64_t seed = 0)
+    -> hash128
+{
+    if (size <= 16)
+    {
+        return detail::_xxh3_128_short(data, size, seed);
+    }
+    if (size <= 240)
+    {
+        return detail::_xxh3_128_medium(data, size, seed);
+    }
+    if (seed == 0)
+    {
+        return detail::_xxh3_128_long(data, size, detail::_xxh3_secret.data());
+    }
+    return detail::_xxh3_128_long(data, size, detail::_xxh3_seeded_secret(seed).data());
+}
+
+template <byte_range Bytes>
+[[nodiscard]] auto xxh3_128(const Bytes& bytes, uint64_t seed = 0) -> hash128
+{
+    return xxh3_128(std::ranges::cdata(bytes), std::ranges::size(bytes), seed);
+}
+
+// Hashes and compares any byte ranges by their contents. Both are transparent, so that unordered
+// containers keyed by byte_string, byte_vector or std::vector<std::byte> using them can look up
+// a byte_span (or any other byte_range) without constructing a key:
+//
+//     std::unordered_map<byte_string, int, byte_hash, byte_equal> map;
+//     map.find(bytes.subspan(4, 8));
+struct byte_hash
+{
+    using is_transparent = void;
+
+    template <byte_range Bytes>
+    [[nodiscard]] auto operator()(const Bytes& bytes) const noexcept -> std::size_t
+    {
+        return static_cast<std::size_t>(xxh3_64(bytes));
+    }
+};
+
+struct byte_equal
+{
+    using is_transparent = void;
+
+    template <byte_range Lhs, byte_range Rhs>
+    [[nodiscard]] bool operator()(const Lhs& lhs, const Rhs& rhs) const noexcept
+    {
+        auto const size = std::ranges::size(lhs);
+        return size == std::ranges::size(rhs) &&
+               (size == 0 ||
+                compare_bytes(std::ranges::cdata(lhs), std::ranges::cdata(rhs), size) == 0);
+    }
+};
+
+} // namespace dualis
+
+// Makes byte containers usable as keys of std::unordered_map and the like.
+template <class Allocator, typename Allocator::size_type EmbeddedSize>
+struct std::hash<dualis::byte_container<Allocator, EmbeddedSize>>
+{
+    [[nodiscard]] auto operator()(
+        const dualis::byte_container<Allocator, EmbeddedSize>& bytes) const noexcept -> std::size_t
+    {
+        return dualis::byte_hash{}(bytes);
+    }
+};
@@ -0,0 +1,342 @@
+#pragma once
+
+#include "containers.h"
+#include "packing.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dualis {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Runtime layouts
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// How the bytes of a field are interpreted.
+enum class field_kind
+{
+    unsigned_integer,
+    signed_integer,
+    // IEEE 754, 4 or 8 bytes wide.
+    floating_point,
+};
+
+// Describes one field of a record whose layout is only known at runtime (e.g. read from a
+// configuration file).
+struct field_description
+{
+    std::string name;
+    // The offset of the field within the record in bytes.
+    std::size_t offset{0};
+    // The width of the field in bytes, from 1 to 8.
+    std::size_t width{0};
+    std::endian order{std::endian::little};
+    field_kind kind{field_kind::unsigned_integer};
+};
+
+namespace detail {
+
+// Moves one field out of a word loaded from a record.
+struct _layout_extract
+{
+    uint32_t column;
+    // The position of the field within the word in bits.
+    uint32_t shift;
+    uint64_t mask;
+    // The most significant bit of signed fields, 0 for unsigned fields.
+    uint64_t sign;
+};
+
+struct _layout_op;
+
+// Runs an operation on a block of records. The column of field f starts at columns[f * stride].
+using _layout_runner = void (*)(const _layout_op& op, const std::byte* records,
+                                std::size_t record_size, std::size_t count, uint64_t* columns,
+                                std::size_t stride);
+
+// Loads a word of up to 8 bytes at offset from every record and extracts one or more fields from
+// it. Adjacent integer fields with the same byte order share a single load.
+struct _layout_op
+{
+    _layout_runner run;
+    uint32_t offset;
+    uint32_t extract_count;
+    std::array<_layout_extract, 8> extracts;
+};
+
+// Records are unpacked in blocks small enough to stay in the L1 cache while all operations run on
+// them.
+inline constexpr std::size_t _layout_block = 256;
+
+// Extracts the fields from the word loaded from each record. The loop over the fields is unrolled,
+// so that their shifts and masks stay in registers.
+template <std::size_t Width, std::endian Order, std::size_t... Fields>
+void _extract_integers(const _layout_op& op, const std::byte* records, std::size_t record_size,
+                       std::size_t count, uint64_t* columns, std::size_t stride,
+                       std::index_sequence<Fields...>)
+{
+    std::array<uint64_t*, sizeof...(Fields)> const targets{
+        columns + op.extracts[Fields].column * stride...};
+    std::array<uint64_t, sizeof...(Fields)> const shifts{op.extracts[Fields].shift...};
+    std::array<uint64_t, sizeof...(Fields)> const masks{op.extracts[Fields].mask...};
+    std::array<uint64_t, sizeof...(Fields)> const signs{op.extracts[Fields].sign...};
+    records += op.offset;
+    for (std::size_t i = 0; i < count; ++i, records += record_size)
+    {
+        uint64_t const word = _sized_integer<Width, false, Order>::unpack(records);
+        // Flipping and subtracting the sign bit sign-extends the field (or does nothing if it is
+        // 0).
+        ((targets[Fields][i] =
+              (((word >> shifts[Fields]) & masks[Fields]) ^ signs[Fields]) - signs[Fields]),
+         ...);
+    }
+}
+
+template <std::size_t Width, std::endian Order, std::size_t Count>
+void _run_integers(const _layout_op& op, const std::byte* records, std::size_t record_size,
+                   std::size_t count, uint64_t* columns, std::size_t stride)
+{
+    _extract_integers<Width, Order>(op, records, record_size, count, columns, stride,
+                                    std::make_index_sequence<Count>{});
+}
+
+template <class T, std::endian Order>
+void _run_floating_point(const _layout_op& op, const std::byte* records, std::size_t record_size,
+                         std::size_t count, uint64_t* columns, std::size_t stride)
+{
+    records += op.offset;
+    auto* column = columns + op.extracts[0].column * stride;
+    for (std::size_t i = 0; i < count; ++i, records += record_size)
+    {
+        auto const value = static_cast<double>(_floating_point<T, Order>::unpack(records));
+        column[i] = std::bit_cast<uint64_t>(value);
+    }
+}
+
+// The integer runners of each load width and number of fields, indexed by
+// (width - 1) * 8 + count - 1.
+template <std::endian Order, std::size_t... Indices>
+[[nodiscard]] constexpr auto _integer_runners(std::index_sequence<Indices...>)
+    -> std::array<_layout_runner, sizeof...(Indices)>
+{
+    return {_run_integers<Indices / 8 + 1, Order, Indices % 8 + 1>...};
+}
+
+template <std::endian Order>
+inline constexpr auto _integer_runner_table =
+    _integer_runners<Order>(std::make_index_sequence<64>{});
+
+} // namespace detail
+
+// A record layout described at runtime. The description is compiled into a short list of
+// operations, in which adjacent integer fields with the same byte order share a single (possibly
+// overlapping) load and gaps between fields are skipped. The operations are then applied to a whole
+// batch of records at once: each operation dispatches once per block of records and runs a loop
+// specialized for its load width, byte order and number of fields, instead of dispatching on every
+// field of every record.
+//
+// Unpacked values are stored as one column of 64-bit slots per field: integers are zero- or
+// sign-extended and floating-point values are converted to double (see as_int64 and as_double).
+class layout
+{
+public:
+    // Throws std::invalid_argument if a field is malformed, ends 4 GiB or more into the record or
+    // exceeds the record. If record_size is 0, records end with the last field.
+    explicit layout(std::vector<field_description> fields, std::size_t record_size = 0)
+        : m_fields{std::move(fields)}
+    {
+        for (auto const& field : m_fields)
+        {
+            if (field.width == 0 || field.width > 8 ||
+                (field.kind == field_kind::floating_point && field.width != 4 && field.width != 8))
+            {
+                throw std::invalid_argument{"invalid width of field " + field.name};
+            }
+            // The operations address fields by 32-bit offsets.
+            if (field.offset > std::numeric_limits<uint32_t>::max() - field.width)
+            {
+                throw std::invalid_argument{"offset of field " + field.name + " is too large"};
+            }
+            m_size = std::max(m_size, field.offset + field.width);
+        }
+        if (record_size != 0 && m_size > record_size)
+        {
+            throw std::invalid_argument{"fields exceed the record size"};
+        }
+        m_size = std::max(m_size, record_size);
+        _compile();
+    }
+
+    // The size of a record in bytes.
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return m_size;
+    }
+
+    [[nodiscard]] auto fields() const noexcept -> const std::vector<field_description>&
+    {
+        return m_fields;
+    }
+
+    [[nodiscard]] auto index_of(std::string_view name) const -> std::optional<std::size_t>
+    {
+        auto const it = std::ranges::find(m_fields, name, &field_description::name);
+        if (it == m_fields.end())
+        {
+            return std::nullopt;
+        }
+        return static_cast<std::size_t>(it - m_fields.begin());
+    }
+
+    // The number of operations the layout was compiled into (at most one per field).
+    [[nodiscard]] auto operation_count() const noexcept -> std::size_t
+    {
+        return m_ops.size();
+    }
+
+    // Unpacks count consecutive records starting at offset. The value of field f of record r is
+    // stored in columns[f * count + r], so columns must hold fields().size() * count slots. Throws
+    // std::out_of_range if the records exceed bytes or the slots exceed columns.
+    void unpack(byte_span bytes, std::size_t offset, std::size_t count,
+                std::span<uint64_t> columns) const
+    {
+        if (offset > bytes.size() || (m_size != 0 && count > (bytes.size() - offset) / m_size))
+        {
+            throw std::out_of_range{"records exceed the bytes"};
+        }
+        if (columns.size() / std::max<std::size_t>(m_fields.size(), 1) < count)
+        {
+            throw std::out_of_range{"not enough columns for the records"};
+        }
+        for (std::size_t first = 0; first < count; first += detail::_layout_block)
+        {
+            auto const block = std::min(detail::_layout_block, count - first);
+            auto const* records = bytes.data() + offset + first * m_size;
+            for (auto const& op : m_ops)
+            {
+                op.run(op, records, m_size, block, columns.data() + first, count);
+            }
+        }
+    }
+
+    // Unpacks count records into newly allocated columns (see above).
+    [[nodiscard]] auto unpack(byte_span bytes, std::size_t offset, std::size_t count) const
+        -> std::vector<uint64_t>
+    {
+        std::vector<uint64_t> columns(m_fields.size() * count);
+        unpack(bytes, offset, count, columns);
+        return columns;
+    }
+
+    // Interpret the slot of an unpacked value.
+    [[nodiscard]] static auto as_int64(uint64_t slot) noexcept -> int64_t
+    {
+        return static_cast<int64_t>(slot);
+    }
+
+    [[nodiscard]] static auto as_double(uint64_t slot) noexcept -> double
+    {
+        return std::bit_cast<double>(slot);
+    }
+
+private:
+    std::vector<field_description> m_fields;
+    std::size_t m_size{0};
+    std::vector<detail::_layout_op> m_ops;
+
+    void _compile()
+    {
+        std::vector<std::size_t> order(m_fields.size());
+        for (std::size_t i = 0; i < order.size(); ++i)
+        {
+            order[i] = i;
+        }
+        std::ranges::stable_sort(order, {}, [this](auto i) { return m_fields[i].offset; });
+
+        for (std::size_t i = 0; i < order.size();)
+        {
+            auto const& first = m_fields[order[i]];
+            if (first.kind == field_kind::floating_point)
+            {
+                _add_floating_point(order[i]);
+                ++i;
+                continue;
+            }
+
+            // Greedily add the following integer fields with the same byte order to the load, as
+            // long as it stays within 8 bytes.
+            auto end = i + 1;
+            auto load_end = first.offset + first.width;
+            for (; end < order.size() && end - i < 8; ++end)
+            {
+                auto const& next = m_fields[order[end]];
+                auto const next_end = std::max(load_end, next.offset + next.width);
+                if (next.kind == field_kind::floating_point || next.order != first.order ||
+                    next_end - first.offset > 8)
+                {
+                    break;
+                }
+                load_end = next_end;
+            }
+            _add_integers(std::span{order}.subspan(i, end - i), first.offset,
+                          load_end - first.offset, first.order);
+            i = end;
+        }
+    }
+
+    void _add_integers(std::span<const std::size_t> fields, std::size_t offset, std::size_t width,
+                       std::endian order)
+    {
+        detail::_layout_op op{};
+        auto const index = (width - 1) * 8 + fields.size() - 1;
+        op.run = order == std::endian::little
+                     ? detail::_integer_runner_table<std::endian::little>[index]
+                     : detail::_integer_runner_table<std::endian::big>[index];
+        op.offset = static_cast<uint32_t>(offset);
+        op.extract_count = static_cast<uint32_t>(fields.size());
+        for (std::size_t j = 0; j < fields.size(); ++j)
+        {
+            auto const& field = m_fields[fields[j]];
+            // Bytes before the field in little endian order, after it in big endian order.
+            auto const skipped = order == std::endian::little
+                                     ? field.offset - offset
+                                     : offset + width - (field.offset + field.width);
+            auto const mask = ~uint64_t{0} >> (64 - 8 * field.width);
+            auto const sign = field.kind == field_kind::signed_integer ? mask ^ (mask >> 1) : 0;
+            op.extracts[j] = {static_cast<uint32_t>(fields[j]), static_cast<uint32_t>(8 * skipped),
+                              mask, sign};
+        }
+        m_ops.push_back(op);
+    }
+
+    void _add_floating_point(std::size_t index)
+    {
+        auto const& field = m_fields[index];
+        detail::_layout_op op{};
+        auto const little = field.order == std::endian::little;
+        if (field.width == 4)
+        {
+            op.run = little ? detail::_run_floating_point<float, std::endian::little>
+                            : detail::_run_floating_point<float, std::endian::big>;
+        }
+        else
+        {
+            op.run = little ? detail::_run_floating_point<double, std::endian::little>
+                            : detail::_run_floating_point<double, std::endian::big>;
+        }
+        op.offset = static_cast<uint32_t>(field.offset);
+        op.extract_count = 1;
+        op.extracts[0].column = static_cast<uint32_t>(index);
+        m_ops.push_back(op);
+    }
+};
+
+} // namespace dualis
@@ -1,10 +1,21 @@
 #pragma once
 
+#include "simd.h"
 #include "utilities.h"
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <concepts>
 #include <cstdint>
+#include <expected>
+#include <limits>
 #include <ranges>
+#include <span>
+#include <string_view>
+#include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace dualis {
 
@@ -32,6 +43,17 @@ public:
         *reinterpret_cast<T*>(bytes) = value;
     }
 
+    // The packed bytes are the in-memory representation of the values, so ranges are copied as is.
+    static void unpack_range(const std::byte* bytes, T* values, std::size_t count)
+    {
+        copy_bytes(reinterpret_cast<std::byte*>(values), bytes, count * sizeof(T));
+    }
+
+    static void pack_range(std::byte* bytes, const T* values, std::size_t count)
+    {
+        copy_bytes(bytes, reinterpret_cast<const std::byte*>(values), count * sizeof(T));
+    }
+
     [[nodiscard]] static constexpr auto size()
     {
         return sizeof(value_type);
@@ -58,6 +80,16 @@ public:
             ::dualis::byte_swap(static_cast<typename std::make_unsigned<T>::type>(value));
     }
 
+    static void unpack_range(const std::byte* bytes, T* values, std::size_t count)
+    {
+        copy_swapped_bytes<sizeof(T)>(reinterpret_cast<std::byte*>(values), bytes, count);
+    }
+
+    static void pack_range(std::byte* bytes, const T* values, std::size_t count)
+    {
+        copy_swapped_bytes<sizeof(T)>(bytes, reinterpret_cast<const std::byte*>(values), count);
+    }
+
     [[nodiscard]] static constexpr auto size()
     {
         return sizeof(value_type);
@@ -88,6 +120,192 @@ using int64_be = big_endian<int64_t>;
 
 static_assert(byte_packing<uint16_le>);
 static_assert(byte_packing<int16_be>);
+static_assert(bulk_byte_packing<int16_be>);
+static_assert(bulk_byte_packing<uint32_le>);
+
+namespace detail {
+
+// Implements packing of integers that take Width bytes, for any Width from 1 to 8 (e.g. 24-bit
+// offsets or 48-bit timestamps). The value_type is the smallest integer that holds Width bytes;
+// signed values are sign-extended from the most significant packed bit. Widths that are no power
+// of two are accessed with two overlapping loads (or stores) instead of byte by byte.
+template <std::size_t Width, bool Signed, std::endian Order> class _sized_integer final
+{
+    static_assert(Width >= 1 && Width <= 8);
+
+public:
+    using value_type =
+        std::conditional_t<Signed, least_signed_int<Width>, least_unsigned_int<Width>>;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes) -> value_type
+    {
+        uint64_t bits;
+        if constexpr (part == Width)
+        {
+            bits = _load(bytes);
+        }
+        else if constexpr (Order == std::endian::little)
+        {
+            bits = _load(bytes) | (_load(bytes + Width - part) << (8 * (Width - part)));
+        }
+        else
+        {
+            bits = (_load(bytes) << (8 * (Width - part))) | _load(bytes + Width - part);
+        }
+        if constexpr (Signed && Width < 8)
+        {
+            constexpr auto unused = 64 - 8 * Width;
+            return static_cast<value_type>(static_cast<int64_t>(bits << unused) >> unused);
+        }
+        else
+        {
+            return static_cast<value_type>(bits);
+        }
+    }
+
+    static void pack(std::byte* bytes, value_type value)
+    {
+        auto const bits = static_cast<uint64_t>(value);
+        if constexpr (part == Width)
+        {
+            _store(bytes, bits);
+        }
+        else if constexpr (Order == std::endian::little)
+        {
+            _store(bytes + Width - part, bits >> (8 * (Width - part)));
+            _store(bytes, bits);
+        }
+        else
+        {
+            _store(bytes, bits >> (8 * (Width - part)));
+            _store(bytes + Width - part, bits);
+        }
+    }
+
+    // 24-bit integers are widened in bulk by shuffling them into 32-bit lanes.
+    static void unpack_range(const std::byte* bytes, value_type* values, std::size_t count)
+    requires(Width == 3)
+    {
+        widen_24_bit<Order, Signed>(reinterpret_cast<uint32_t*>(values), bytes, count);
+    }
+
+    static void pack_range(std::byte* bytes, const value_type* values, std::size_t count)
+    requires(Width == 3)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            pack(bytes + i * Width, values[i]);
+        }
+    }
+
+    [[nodiscard]] static constexpr auto size()
+    {
+        return Width;
+    }
+
+private:
+    // The width of each of the two overlapping parts: the largest power of two up to Width.
+    static constexpr std::size_t part = std::bit_floor(Width);
+    using part_type = unsigned_int<part>;
+    using part_packing = std::conditional_t<Order == std::endian::little, little_endian<part_type>,
+                                            big_endian<part_type>>;
+
+    [[nodiscard]] static auto _load(const std::byte* bytes) -> uint64_t
+    {
+        return part_packing::unpack(bytes);
+    }
+
+    static void _store(std::byte* bytes, uint64_t bits)
+    {
+        part_packing::pack(bytes, static_cast<part_type>(bits));
+    }
+};
+
+} // namespace detail
+
+template <std::size_t Width>
+using uint_le = detail::_sized_integer<Width, false, std::endian::little>;
+template <std::size_t Width>
+using uint_be = detail::_sized_integer<Width, false, std::endian::big>;
+template <std::size_t Width>
+using int_le = detail::_sized_integer<Width, true, std::endian::little>;
+template <std::size_t Width>
+using int_be = detail::_sized_integer<Width, true, std::endian::big>;
+
+using uint24_le = uint_le<3>;
+using uint24_be = uint_be<3>;
+using int24_le = int_le<3>;
+using int24_be = int_be<3>;
+using uint48_le = uint_le<6>;
+using uint48_be = uint_be<6>;
+
+static_assert(byte_packing<uint_le<5>>);
+static_assert(bulk_byte_packing<int24_be>);
+
+namespace detail {
+
+// Implements packing of a floating-point type T in IEEE 754 format with the given byte order by
+// reinterpreting its bits as an unsigned integer of the same width.
+template <std::floating_point T, std::endian Order> class _floating_point final
+{
+    static_assert(std::numeric_limits<T>::is_iec559);
+
+    using bits_type = unsigned_int<sizeof(T)>;
+    using bits_packing = std::conditional_t<Order == std::endian::little, little_endian<bits_type>,
+                                            big_endian<bits_type>>;
+
+public:
+    using value_type = T;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes) -> T
+    {
+        return std::bit_cast<T>(bits_packing::unpack(bytes));
+    }
+
+    static void pack(std::byte* bytes, T value)
+    {
+        bits_packing::pack(bytes, std::bit_cast<bits_type>(value));
+    }
+
+    static void unpack_range(const std::byte* bytes, T* values, std::size_t count)
+    {
+        if constexpr (Order == std::endian::native)
+        {
+            copy_bytes(reinterpret_cast<std::byte*>(values), bytes, count * sizeof(T));
+        }
+        else
+        {
+            copy_swapped_bytes<sizeof(T)>(reinterpret_cast<std::byte*>(values), bytes, count);
+        }
+    }
+
+    static void pack_range(std::byte* bytes, const T* values, std::size_t count)
+    {
+        if constexpr (Order == std::endian::native)
+        {
+            copy_bytes(bytes, reinterpret_cast<const std::byte*>(values), count * sizeof(T));
+        }
+        else
+        {
+            copy_swapped_bytes<sizeof(T)>(bytes, reinterpret_cast<const std::byte*>(values), count);
+        }
+    }
+
+    [[nodiscard]] static constexpr auto size()
+    {
+        return sizeof(value_type);
+    }
+};
+
+} // namespace detail
+
+using float32_le = detail::_floating_point<float, std::endian::little>;
+using float64_le = detail::_floating_point<double, std::endian::little>;
+using float32_be = detail::_floating_point<float, std::endian::big>;
+using float64_be = detail::_floating_point<double, std::endian::big>;
+
+static_assert(bulk_byte_packing<float32_le>);
+static_assert(bulk_byte_packing<float64_be>);
 
 // Implements packing of any default-initializable type T into bytes and from bytes using the memory
 // layout given by the compiler. This might not match across different compilers (e.g. alignment,
@@ -108,149 +326,1334 @@ template <std::default_initializable T> struct raw
         copy_bytes(bytes, reinterpret_cast<const std::byte*>(&value), size());
     }
 
+    static void unpack_range(const std::byte* bytes, T* values, std::size_t count)
+    requires std::is_trivially_copyable_v<T>
+    {
+        copy_bytes(reinterpret_cast<std::byte*>(values), bytes, count * size());
+    }
+
+    static void pack_range(std::byte* bytes, const T* values, std::size_t count)
+    requires std::is_trivially_copyable_v<T>
+    {
+        copy_bytes(bytes, reinterpret_cast<const std::byte*>(values), count * size());
+    }
+
     [[nodiscard]] static constexpr auto size()
     {
         return sizeof(value_type);
     }
 };
 
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Typed packings
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
 namespace detail {
 
-template <byte_packing Packing>
-[[nodiscard]] auto _unpack_from(const std::byte* bytes, Packing)
-    -> std::tuple<typename Packing::value_type>
+// Converts between a typed value and the value_type of the packing it is packed with: by
+// static_cast if possible (e.g. enumerations and aggregates with a single member), otherwise by
+// reinterpreting the bits of a type of the same size (e.g. strong typedefs without conversions).
+template <class To, class From> [[nodiscard]] constexpr auto _convert(const From& value) -> To
 {
-    return std::make_tuple(Packing::unpack(bytes));
+    if constexpr (requires { static_cast<To>(value); })
+    {
+        return static_cast<To>(value);
+    }
+    else
+    {
+        static_assert(sizeof(To) == sizeof(From) && std::is_trivially_copyable_v<To> &&
+                          std::is_trivially_copyable_v<From>,
+                      "the types must be convertible or of the same size");
+        return std::bit_cast<To>(value);
+    }
 }
 
-template <byte_packing Packing, byte_packing... Packings>
-[[nodiscard]] auto _unpack_from(const std::byte* bytes, Packing, Packings... packings)
+// Whether value is valid according to Packing; values of packings that do not validate always are.
+template <byte_packing Packing>
+[[nodiscard]] constexpr auto _is_valid(const typename Packing::value_type& value) -> bool
 {
-    auto const value = Packing::unpack(bytes);
-    auto const remaining = _unpack_from(bytes + Packing::size(), packings...);
-    return std::tuple_cat(std::make_tuple(value), remaining);
+    if constexpr (validating_byte_packing<Packing>)
+    {
+        return Packing::is_valid(value);
+    }
+    else
+    {
+        return true;
+    }
 }
 
-template <byte_packing Packing, byte_packing... Packings>
-void _pack_into(std::byte* bytes, typename Packing::value_type value,
-                typename Packings::value_type... values)
+// A compile-time set of integers that finds the index of a value among them. If they span at most
+// 1024 values, the index is looked up in a table covering that range; otherwise, they are compared
+// one by one. Values that are not in the set map to the number of values.
+template <std::integral Integer, Integer... Values> struct _integer_set
 {
-    Packing::pack(bytes, value);
-    if constexpr (sizeof...(Packings) > 0)
+    static constexpr std::size_t count = sizeof...(Values);
+    static_assert(count > 0);
+
+    static constexpr std::array<Integer, count> values{Values...};
+    static constexpr Integer lowest = std::ranges::min(values);
+
+    // The distance of value from lowest, computed in the unsigned type of the same width so that it
+    // cannot overflow. Values below lowest wrap around to large distances.
+    [[nodiscard]] static constexpr auto distance(Integer value) -> uint64_t
     {
-        _pack_into<Packings...>(bytes + Packing::size(), values...);
+        using bits_type = std::make_unsigned_t<Integer>;
+        return static_cast<bits_type>(static_cast<bits_type>(value) -
+                                      static_cast<bits_type>(lowest));
     }
-}
 
-template <std::size_t Index, byte_packing... Packings>
-void _pack_into(std::byte* bytes, const std::tuple<typename Packings::value_type...>& values)
-{
-    if constexpr (Index < sizeof...(Packings))
+    static constexpr uint64_t range = distance(std::ranges::max(values));
+    static constexpr bool uses_table = range < 1024;
+
+    static constexpr bool distinct = [] {
+        auto sorted = values;
+        std::ranges::sort(sorted);
+        return std::ranges::adjacent_find(sorted) == sorted.end();
+    }();
+
+    [[nodiscard]] static constexpr auto find(Integer value) -> std::size_t
     {
-        using Packing = std::tuple_element_t<Index, std::tuple<Packings...>>;
-        Packing::pack(std::get<Index>(values), bytes);
-        _pack_into<Index + 1, Packings...>(bytes + Packing::size(), values);
+        if constexpr (uses_table)
+        {
+            auto const offset = distance(value);
+            return offset <= range ? table[offset] : count;
+        }
+        else
+        {
+            return static_cast<std::size_t>(std::ranges::find(values, value) - values.begin());
+        }
     }
-}
+
+    [[nodiscard]] static constexpr auto contains(Integer value) -> bool
+    {
+        return find(value) != count;
+    }
+
+private:
+    // With a table, there are at most 1024 distinct values.
+    using index_type = std::conditional_t<(count < std::numeric_limits<uint8_t>::max()), uint8_t,
+                                          uint16_t>;
+
+    static constexpr auto table = [] {
+        std::array<index_type, uses_table ? range + 1 : 0> table{};
+        if constexpr (uses_table)
+        {
+            table.fill(static_cast<index_type>(count));
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                table[distance(values[i])] = static_cast<index_type>(i);
+            }
+        }
+        return table;
+    }();
+};
+
+// A compile-time set of enumerators.
+template <class E, E... Values>
+using _enum_set = _integer_set<std::underlying_type_t<E>, std::to_underlying(Values)...>;
 
 } // namespace detail
 
-// Packs or unpacks multiple values of differing types in sequence. Each type must be specified as
-// another packing.
-template <byte_packing... Packings> struct tuple_packing
+// Packs a value of type T as Packing packs its value_type, so that unpacking yields T directly
+// (e.g. a strong typedef of an integer). Values are converted by static_cast if possible, otherwise
+// their bits are reinterpreted.
+template <class T, byte_packing Packing> struct as
 {
-    static_assert(sizeof...(Packings) > 0);
-    using value_type = std::tuple<typename Packings::value_type...>;
+    using value_type = T;
 
-    [[nodiscard]] static auto unpack(const std::byte* bytes) -> value_type
+    [[nodiscard]] static auto unpack(const std::byte* bytes) -> T
     {
-        return detail::_unpack_from(bytes, Packings{}...);
+        return detail::_convert<T>(Packing::unpack(bytes));
     }
 
-    static void pack(std::byte* bytes, const value_type& value)
+    static void pack(std::byte* bytes, const T& value)
+    {
+        Packing::pack(bytes, detail::_convert<typename Packing::value_type>(value));
+    }
+
+    [[nodiscard]] static constexpr auto size()
+    {
+        return Packing::size();
+    }
+};
+
+// Packs an enumeration E as its underlying value using Packing. If valid enumerators are given,
+// the packing validates unpacked values against them, so that the checked unpacking functions
+// reject unknown values.
+template <class E, byte_packing Packing, E... Valid>
+requires std::is_enum_v<E>
+struct enum_packing
+{
+    using value_type = E;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes) -> E
+    {
+        return static_cast<E>(Packing::unpack(bytes));
+    }
+
+    static void pack(std::byte* bytes, E value)
     {
-        detail::_pack_into<0, Packings...>(bytes, value);
+        Packing::pack(bytes, static_cast<typename Packing::value_type>(value));
     }
 
-    // Convenience method for pack_tuple that circumvents the construction of an std::tuple.
-    static void pack(std::byte* bytes, const typename Packings::value_type&... values)
+    [[nodiscard]] static constexpr auto is_valid(E value) -> bool
+    requires(sizeof...(Valid) > 0)
     {
-        detail::_pack_into<Packings...>(bytes, values...);
+        return detail::_enum_set<E, Valid...>::contains(std::to_underlying(value));
     }
 
     [[nodiscard]] static constexpr auto size()
     {
-        return (Packings::size() + ...);
+        return Packing::size();
     }
 };
 
-// Make sure tuple_packing is a packing using example arguments.
-static_assert(byte_packing<tuple_packing<uint16_le>>);
-static_assert(byte_packing<tuple_packing<uint16_le, uint16_le>>);
+// Packs a bool as an integer using Packing: unpacking yields whether it is non-zero, packing
+// writes 0 or 1.
+template <byte_packing Packing = raw<uint8_t>> struct bool_packing
+{
+    using value_type = bool;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes) -> bool
+    {
+        return Packing::unpack(bytes) != 0;
+    }
+
+    static void pack(std::byte* bytes, bool value)
+    {
+        Packing::pack(bytes, static_cast<typename Packing::value_type>(value ? 1 : 0));
+    }
+
+    [[nodiscard]] static constexpr auto size()
+    {
+        return Packing::size();
+    }
+};
+
+static_assert(byte_packing<as<uint64_t, uint32_le>>);
+static_assert(validating_byte_packing<enum_packing<std::byte, raw<uint8_t>, std::byte{0}>>);
+static_assert(!validating_byte_packing<enum_packing<std::byte, raw<uint8_t>>>);
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
-// Packing of singular type
+// Pseudo packings
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
-template <byte_packing Packing, byte_range Bytes>
-[[nodiscard]] auto unpack(const Bytes& bytes, std::size_t offset) -> typename Packing::value_type
+// Skips N bytes, such as reserved fields. Packing leaves the bytes unchanged.
+template <std::size_t N> struct skip
 {
-    return Packing::unpack(std::ranges::cdata(bytes) + offset);
-}
+    [[nodiscard]] static constexpr auto size(std::size_t /*offset*/) -> std::size_t
+    {
+        return N;
+    }
 
-template <byte_packing Packing, class U, writable_byte_range Bytes>
-void pack(Bytes& bytes, std::size_t offset, const U& value)
+    static void pack(std::byte* /*bytes*/, std::size_t /*offset*/) {}
+};
+
+// Skips N bytes of padding. Packing fills them with Fill.
+template <std::size_t N, std::byte Fill = std::byte{0}> struct pad
 {
-    Packing::pack(std::ranges::data(bytes) + offset, typename Packing::value_type(value));
-}
+    [[nodiscard]] static constexpr auto size(std::size_t /*offset*/) -> std::size_t
+    {
+        return N;
+    }
 
-///////////////////////////////////////////////////////////////////////////////////////////////////
-// Compound packing (multiple types, multiple values of same type)
-///////////////////////////////////////////////////////////////////////////////////////////////////
+    static void pack(std::byte* bytes, std::size_t /*offset*/)
+    {
+        set_bytes(bytes, Fill, N);
+    }
+};
 
-template <byte_packing... Packings, byte_range Bytes>
-[[nodiscard]] auto unpack_tuple(const Bytes& bytes, std::size_t offset)
+// Skips to the next multiple of N bytes, counted from the start of the enclosing tuple_packing (or
+// of the byte_stream's span). Packing fills the skipped bytes with Fill.
+template <std::size_t N, std::byte Fill = std::byte{0}>
+requires(N > 0)
+struct align
 {
-    return unpack<tuple_packing<Packings...>>(bytes, offset);
+    [[nodiscard]] static constexpr auto size(std::size_t offset) -> std::size_t
+    {
+        return (N - offset % N) % N;
+    }
+
+    static void pack(std::byte* bytes, std::size_t offset)
+    {
+        set_bytes(bytes, Fill, size(offset));
+    }
+};
+
+namespace detail {
+
+// The byte order of packings that store integers (or enumerations) as their plain bits, so that
+// the bytes of a constant can be computed at compile time.
+template <class Packing> struct _integer_order
+{
+};
+
+template <std::integral T> struct _integer_order<_little_endian_ptrcast<T>>
+{
+    static constexpr auto value = std::endian::little;
+};
+
+template <std::integral T> struct _integer_order<_big_endian_ptrcast<T>>
+{
+    static constexpr auto value = std::endian::big;
+};
+
+template <std::size_t Width, bool Signed, std::endian Order>
+struct _integer_order<_sized_integer<Width, Signed, Order>>
+{
+    static constexpr auto value = Order;
+};
+
+template <class T>
+requires std::integral<T> || std::is_enum_v<T>
+struct _integer_order<raw<T>>
+{
+    static constexpr auto value = std::endian::native;
+};
+
+template <class T, class Packing>
+struct _integer_order<as<T, Packing>> : _integer_order<Packing>
+{
+};
+
+template <class E, class Packing, E... Valid>
+struct _integer_order<enum_packing<E, Packing, Valid...>> : _integer_order<Packing>
+{
+};
+
+template <class Packing>
+concept _integer_packing = byte_packing<Packing> && requires { _integer_order<Packing>::value; };
+
+// The bytes of value packed with Packing, computed at compile time.
+template <_integer_packing Packing>
+[[nodiscard]] constexpr auto _integer_image(const typename Packing::value_type& value)
+    -> std::array<std::byte, Packing::size()>
+{
+    using value_type = typename Packing::value_type;
+    using integer_type = typename std::conditional_t<std::is_enum_v<value_type>,
+                                                     std::underlying_type<value_type>,
+                                                     std::type_identity<value_type>>::type;
+    auto const bits = static_cast<uint64_t>(
+        static_cast<std::make_unsigned_t<integer_type>>(static_cast<integer_type>(value)));
+    std::array<std::byte, Packing::size()> image{};
+    for (std::size_t i = 0; i < image.size(); ++i)
+    {
+        auto const shift = _integer_order<Packing>::value == std::endian::little
+                               ? 8 * i
+                               : 8 * (image.size() - 1 - i);
+        image[i] = static_cast<std::byte>(bits >> shift);
+    }
+    return image;
 }
 
-template <byte_packing... Packings, writable_byte_range Bytes>
-void pack_tuple(Bytes& bytes, std::size_t offset, const typename Packings::value_type&... values)
+// Whether the bytes selected by Mask equal those of Image. The bytes are compared in words of up
+// to 8 bytes, and the differences are combined so that there is a single branch.
+template <std::size_t N, std::array<std::byte, N> Image, std::array<std::byte, N> Mask>
+[[nodiscard]] auto _matches(const std::byte* bytes) -> bool
 {
-    tuple_packing<Packings...>::pack(std::ranges::data(bytes) + offset, values...);
+    static constexpr auto count = (N + 7) / 8;
+    static constexpr auto words = [] {
+        std::array<uint64_t, count> image{}, mask{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            image[i / 8] |= std::to_integer<uint64_t>(Image[i]) << (8 * (i % 8));
+            mask[i / 8] |= std::to_integer<uint64_t>(Mask[i]) << (8 * (i % 8));
+        }
+        return std::pair{image, mask};
+    }();
+    return [&]<std::size_t... Words>(std::index_sequence<Words...>) {
+        return (((static_cast<uint64_t>(
+                      uint_le<std::min<std::size_t>(8, N - 8 * Words)>::unpack(bytes + 8 * Words)) ^
+                  words.first[Words]) &
+                 words.second[Words]) |
+                ...) == 0;
+    }(std::make_index_sequence<count>{});
 }
 
-// Unpacks n values into the given output iterator.
-template <byte_packing Packing, byte_range Bytes, class Iterator>
-requires std::output_iterator<Iterator, typename Packing::value_type>
-auto unpack_range(const Bytes& bytes, std::size_t offset, Iterator first, std::size_t count)
-    -> Iterator
+template <std::size_t N>
+inline constexpr auto _full_mask = [] {
+    std::array<std::byte, N> mask{};
+    mask.fill(std::byte{0xff});
+    return mask;
+}();
+
+// Pseudo packing of the constant Bytes: packing writes them, and matches tells whether given bytes
+// equal them.
+template <std::size_t N, std::array<std::byte, N> Bytes>
+requires(N > 0)
+struct _constant_bytes
 {
-    for (decltype(count) i = 0; i < count; ++i)
+    static constexpr auto signature = Bytes;
+
+    [[nodiscard]] static constexpr auto size(std::size_t /*offset*/) -> std::size_t
     {
-        *first++ = unpack<Packing>(bytes, offset);
-        offset += Packing::size();
+        return N;
     }
-    return first;
-}
 
-template <byte_packing Packing, writable_byte_range Bytes, std::input_iterator Iterator>
-void pack_range(Bytes& bytes, std::size_t offset, Iterator first, Iterator last)
+    static void pack(std::byte* bytes, std::size_t /*offset*/)
+    {
+        copy_bytes(bytes, signature.data(), N);
+    }
+
+    [[nodiscard]] static auto matches(const std::byte* bytes) -> bool
+    {
+        return _matches<N, Bytes, _full_mask<N>>(bytes);
+    }
+};
+
+// The characters of a string literal without the terminating null, as a template argument.
+template <std::size_t N> struct _string_literal
+{
+    constexpr _string_literal(const char (&string)[N])
+    {
+        for (std::size_t i = 0; i + 1 < N; ++i)
+        {
+            bytes[i] = static_cast<std::byte>(string[i]);
+        }
+    }
+
+    std::array<std::byte, N - 1> bytes{};
+};
+
+} // namespace detail
+
+// Expects Value packed with Packing, such as a magic number or a version. Packing must store an
+// integer or an enumeration (e.g. uint32_le or enum_packing), so that the expected bytes are known
+// at compile time. Unpacking skips the bytes, packing writes Value, and checked unpacking (or
+// matches) rejects other bytes. Within a tuple_packing, all expected bytes are compared at once.
+template <byte_packing Packing, auto Value>
+requires detail::_integer_packing<Packing>
+using expect = detail::_constant_bytes<
+    Packing::size(),
+    detail::_integer_image<Packing>(static_cast<typename Packing::value_type>(Value))>;
+
+// Expects the characters of a string literal (without the terminating null), e.g.
+// expect_bytes<"RIFF">. Behaves like expect.
+template <detail::_string_literal Literal>
+using expect_bytes = detail::_constant_bytes<Literal.bytes.size(), Literal.bytes>;
+
+static_assert(pseudo_packing<skip<4>>);
+static_assert(pseudo_packing<pad<4, std::byte{0xff}>>);
+static_assert(pseudo_packing<align<8>>);
+static_assert(!byte_packing<skip<4>>);
+static_assert(signature_packing<expect<uint16_be, 0x4d42>>);
+static_assert(std::same_as<expect<uint16_be, 0x4d42>, expect_bytes<"MB">>);
+
+namespace detail {
+
+// Whether Packing stores an integer exactly as it is laid out in host memory, so that adjacent
+// values can be loaded (or stored) together and split (or combined) in registers.
+template <class Packing> inline constexpr bool _is_native_integer = false;
+
+template <std::integral T>
+inline constexpr bool _is_native_integer<_little_endian_ptrcast<T>> =
+    std::endian::native == std::endian::little && !std::same_as<T, bool>;
+
+template <std::integral T>
+inline constexpr bool _is_native_integer<raw<T>> =
+    std::endian::native == std::endian::little && !std::same_as<T, bool>;
+
+// Enumerations and integers of the packed width are converted to and from the bits of the packed
+// value by static_cast, so they can be fused as well.
+template <class T, class Packing>
+inline constexpr bool _is_native_integer<as<T, Packing>> =
+    _is_native_integer<Packing> && (std::is_enum_v<T> || std::integral<T>) &&
+    !std::same_as<T, bool> && sizeof(T) == Packing::size();
+
+template <class E, class Packing, E... Valid>
+inline constexpr bool _is_native_integer<enum_packing<E, Packing, Valid...>> =
+    _is_native_integer<Packing> && sizeof(E) == Packing::size();
+
+// A packing that can be an element of a tuple_packing.
+template <class Packing>
+concept _tuple_element = byte_packing<Packing> || pseudo_packing<Packing>;
+
+template <_tuple_element Packing>
+[[nodiscard]] constexpr auto _size_at(std::size_t offset) -> std::size_t
 {
-    while (first != last)
+    if constexpr (pseudo_packing<Packing>)
+    {
+        return Packing::size(offset);
+    }
+    else
     {
-        pack<Packing>(bytes, offset, *first++);
-        offset += Packing::size();
+        return Packing::size();
     }
 }
 
-template <byte_packing Packing, writable_byte_range Bytes, std::ranges::range Range>
-void pack_range(Bytes& bytes, std::size_t offset, const Range& range)
+// The values a packing contributes to the value_type of a tuple_packing.
+template <class Packing> struct _tuple_values
+{
+    using type = std::tuple<typename Packing::value_type>;
+};
+
+template <pseudo_packing Packing> struct _tuple_values<Packing>
 {
-    for (auto const& value : range)
+    using type = std::tuple<>;
+};
+
+// Copies the constant bytes of Packing, if it is a signature_packing, into image at offset, and
+// selects them in mask.
+template <class Packing, std::size_t N>
+constexpr void _copy_signature(std::array<std::byte, N>& image, std::array<std::byte, N>& mask,
+                               std::size_t offset)
+{
+    if constexpr (signature_packing<Packing>)
+    {
+        for (std::size_t i = 0; i < Packing::signature.size(); ++i)
+        {
+            image[offset + i] = Packing::signature[i];
+            mask[offset + i] = std::byte{0xff};
+        }
+    }
+}
+
+// Compile-time plan for packing or unpacking a tuple_packing. Runs of adjacent native integers
+// whose combined size is 2, 4 or 8 bytes are grouped, and each group is accessed with a single load
+// or store; all other packings are accessed one by one. Pseudo packings are never loaded.
+template <_tuple_element... Packings> struct _tuple_plan
+{
+    static constexpr std::size_t count = sizeof...(Packings);
+    static constexpr std::array<bool, count> native{_is_native_integer<Packings>...};
+    static constexpr std::array<bool, count> pseudo{pseudo_packing<Packings>...};
+
+    using value_type =
+        decltype(std::tuple_cat(std::declval<typename _tuple_values<Packings>::type>()...));
+    static constexpr std::size_t value_count = std::tuple_size_v<value_type>;
+
+    // The offset of each packing, followed by the size of the whole tuple.
+    static constexpr auto offsets = [] {
+        std::array<std::size_t, count + 1> offsets{};
+        std::size_t i = 0;
+        ((offsets[i + 1] = offsets[i] + _size_at<Packings>(offsets[i]), ++i), ...);
+        return offsets;
+    }();
+
+    static constexpr auto sizes = [] {
+        std::array<std::size_t, count> sizes{};
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            sizes[i] = offsets[i + 1] - offsets[i];
+        }
+        return sizes;
+    }();
+
+    // For each value, the index of the packing it belongs to, and for each packing, the index of
+    // its value (or value_count for pseudo packings).
+    static constexpr auto value_packings = [] {
+        std::array<std::size_t, value_count> value_packings{};
+        for (std::size_t i = 0, j = 0; i < count; ++i)
+        {
+            if (!pseudo[i])
+            {
+                value_packings[j++] = i;
+            }
+        }
+        return value_packings;
+    }();
+
+    static constexpr auto value_indices = [] {
+        std::array<std::size_t, count> value_indices{};
+        for (std::size_t i = 0, j = 0; i < count; ++i)
+        {
+            value_indices[i] = pseudo[i] ? value_count : j++;
+        }
+        return value_indices;
+    }();
+
+    // The range of bytes from the first to the last signature packing, and their constant bytes
+    // along with a mask selecting them (skipping the bytes in between).
+    static constexpr std::array<bool, count> constant{signature_packing<Packings>...};
+
+    static constexpr auto signature_begin = [] {
+        auto const first = std::ranges::find(constant, true) - constant.begin();
+        return offsets[static_cast<std::size_t>(first)];
+    }();
+
+    static constexpr auto signature_end = [] {
+        auto const last = std::ranges::find(constant | std::views::reverse, true).base();
+        auto const end = static_cast<std::size_t>(last - constant.begin());
+        return end == 0 ? signature_begin : offsets[end];
+    }();
+
+    static constexpr std::size_t signature_size = signature_end - signature_begin;
+
+    static constexpr auto signature = [] {
+        std::array<std::byte, offsets.back()> image{}, mask{};
+        std::size_t i = 0;
+        (_copy_signature<Packings>(image, mask, offsets[i++]), ...);
+        std::array<std::byte, signature_size> image_range{}, mask_range{};
+        std::ranges::copy_n(image.begin() + signature_begin, signature_size, image_range.begin());
+        std::ranges::copy_n(mask.begin() + signature_begin, signature_size, mask_range.begin());
+        return std::pair{image_range, mask_range};
+    }();
+
+    [[nodiscard]] static auto matches(const std::byte* bytes) -> bool
+    {
+        return _matches<signature_size, signature.first, signature.second>(
+            bytes + signature_begin);
+    }
+
+    // For each packing, the index of the first packing in its group (or its own index if it is not
+    // grouped) and the size of the whole group in bytes (or 0 if it is not grouped). Greedily picks
+    // the longest suitable run starting at each packing.
+    static constexpr auto groups = [] {
+        std::array<std::size_t, count> first{}, width{};
+        std::size_t i = 0;
+        while (i < count)
+        {
+            std::size_t end = i + 1, group_width = 0, total = 0;
+            for (std::size_t j = i; j < count && native[j] && total + sizes[j] <= 8; ++j)
+            {
+                total += sizes[j];
+                if (j > i && (total == 2 || total == 4 || total == 8))
+                {
+                    end = j + 1;
+                    group_width = total;
+                }
+            }
+            for (auto const start = i; i < end; ++i)
+            {
+                first[i] = start;
+                width[i] = group_width;
+            }
+        }
+        return std::pair{first, width};
+    }();
+
+    template <std::size_t Index>
+    using packing = std::tuple_element_t<Index, std::tuple<Packings...>>;
+
+    template <std::size_t Index>
+    static constexpr bool is_group_start =
+        groups.second[Index] != 0 && groups.first[Index] == Index;
+
+    template <std::size_t Index>
+    static constexpr std::size_t shift = 8 * (offsets[Index] - offsets[groups.first[Index]]);
+
+    template <std::size_t Index> [[nodiscard]] static auto load(const std::byte* bytes) -> uint64_t
+    {
+        if constexpr (is_group_start<Index>)
+        {
+            using word_type = unsigned_int<groups.second[Index]>;
+            return little_endian<word_type>::unpack(bytes + offsets[Index]);
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    template <std::size_t Index>
+    [[nodiscard]] static auto unpack_one(const std::byte* bytes,
+                                         const std::array<uint64_t, count>& words) ->
+        typename packing<Index>::value_type
+    {
+        using value_type = typename packing<Index>::value_type;
+        if constexpr (groups.second[Index] == 0)
+        {
+            return packing<Index>::unpack(bytes + offsets[Index]);
+        }
+        else
+        {
+            auto const word = words[groups.first[Index]] >> shift<Index>;
+            return static_cast<value_type>(static_cast<unsigned_int<sizeof(value_type)>>(word));
+        }
+    }
+
+    template <std::size_t... Indices, std::size_t... Values>
+    [[nodiscard]] static auto unpack(const std::byte* bytes, std::index_sequence<Indices...>,
+                                     std::index_sequence<Values...>) -> value_type
+    {
+        std::array<uint64_t, count> const words{load<Indices>(bytes)...};
+        return {unpack_one<value_packings[Values]>(bytes, words)...};
+    }
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes) -> value_type
+    {
+        return unpack(bytes, std::make_index_sequence<count>{},
+                      std::make_index_sequence<value_count>{});
+    }
+
+    template <std::size_t Index, class Tuple>
+    static void pack_one(std::byte* bytes, const Tuple& values, std::array<uint64_t, count>& words)
+    {
+        if constexpr (pseudo[Index])
+        {
+            packing<Index>::pack(bytes + offsets[Index], offsets[Index]);
+        }
+        else if constexpr (groups.second[Index] == 0)
+        {
+            packing<Index>::pack(bytes + offsets[Index], std::get<value_indices[Index]>(values));
+        }
+        else
+        {
+            using value_type = typename packing<Index>::value_type;
+            using bits_type = unsigned_int<sizeof(value_type)>;
+            auto const value = static_cast<value_type>(std::get<value_indices[Index]>(values));
+            words[groups.first[Index]] |= static_cast<uint64_t>(static_cast<bits_type>(value))
+                                          << shift<Index>;
+        }
+    }
+
+    template <std::size_t Index>
+    static void store(std::byte* bytes, const std::array<uint64_t, count>& words)
+    {
+        if constexpr (is_group_start<Index>)
+        {
+            using word_type = unsigned_int<groups.second[Index]>;
+            little_endian<word_type>::pack(bytes + offsets[Index],
+                                           static_cast<word_type>(words[Index]));
+        }
+    }
+
+    template <class Tuple, std::size_t... Indices>
+    static void pack(std::byte* bytes, const Tuple& values, std::index_sequence<Indices...>)
+    {
+        std::array<uint64_t, count> words{};
+        (pack_one<Indices>(bytes, values, words), ...);
+        (store<Indices>(bytes, words), ...);
+    }
+
+    template <class Tuple> static void pack(std::byte* bytes, const Tuple& values)
+    {
+        pack(bytes, values, std::make_index_sequence<count>{});
+    }
+
+    // Whether each value is valid according to its packing.
+    template <std::size_t... Values>
+    [[nodiscard]] static auto is_valid(const value_type& value, std::index_sequence<Values...>)
+        -> bool
+    {
+        return (_is_valid<packing<value_packings[Values]>>(std::get<Values>(value)) && ...);
+    }
+};
+
+} // namespace detail
+
+// Packs or unpacks multiple values of differing types in sequence. Each type must be specified as
+// another packing. Adjacent native-order integers are fused into single loads and stores.
+//
+// Pseudo packings (skip, pad and align) may be interspersed to skip bytes without unpacking them;
+// they are omitted from the value_type, and packing writes their fill bytes. Signature packings
+// (expect and expect_bytes) are skipped likewise, but checked by matches and checked unpacking.
+template <detail::_tuple_element... Packings> struct tuple_packing
+{
+    static_assert(sizeof...(Packings) > 0);
+    using value_type = typename detail::_tuple_plan<Packings...>::value_type;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes) -> value_type
+    {
+        return plan::unpack(bytes);
+    }
+
+    static void pack(std::byte* bytes, const value_type& value)
+    {
+        plan::pack(bytes, value);
+    }
+
+    // Convenience method for pack_tuple that circumvents the construction of an std::tuple. Each
+    // value is converted to the value_type of its packing.
+    template <class... Values>
+    requires(sizeof...(Values) == std::tuple_size_v<value_type>)
+    static void pack(std::byte* bytes, const Values&... values)
+    {
+        plan::pack(bytes, std::forward_as_tuple(values...));
+    }
+
+    // Whether each value is valid according to its packing.
+    [[nodiscard]] static auto is_valid(const value_type& value) -> bool
+    requires(validating_byte_packing<Packings> || ...)
+    {
+        return plan::is_valid(value, std::make_index_sequence<plan::value_count>{});
+    }
+
+    // Whether the bytes of all signature packings (e.g. expect and expect_bytes) match, checked
+    // with a single masked comparison of the bytes they span.
+    [[nodiscard]] static auto matches(const std::byte* bytes) -> bool
+    requires(signature_packing<Packings> || ...)
+    {
+        return plan::matches(bytes);
+    }
+
+    [[nodiscard]] static constexpr auto size() -> std::size_t
+    {
+        return plan::offsets.back();
+    }
+
+private:
+    using plan = detail::_tuple_plan<Packings...>;
+};
+
+// Make sure tuple_packing is a packing using example arguments.
+static_assert(byte_packing<tuple_packing<uint16_le>>);
+static_assert(byte_packing<tuple_packing<uint16_le, uint16_le>>);
+static_assert(byte_packing<tuple_packing<uint16_le, skip<2>, align<8>>>);
+static_assert(tuple_packing<raw<uint8_t>, align<4>, uint32_le, pad<3>, align<4>>::size() == 12);
+
+namespace detail {
+
+template <class T> struct _member_pointer_traits;
+
+template <class Class, class Member> struct _member_pointer_traits<Member Class::*>
+{
+    using class_type = Class;
+    using member_type = Member;
+};
+
+} // namespace detail
+
+// Describes a field of a struct_packing: the data member it is stored in and how it is packed. The
+// member's type need not be the packing's value_type, but must be convertible by static_cast (for
+// example, an enum and its underlying type).
+template <auto Member, byte_packing Packing> struct field
+{
+    using packing = Packing;
+    using class_type = typename detail::_member_pointer_traits<decltype(Member)>::class_type;
+    using member_type = typename detail::_member_pointer_traits<decltype(Member)>::member_type;
+
+    static void unpack_into(const std::byte* bytes, class_type& value)
+    {
+        value.*Member = static_cast<member_type>(Packing::unpack(bytes));
+    }
+
+    static void pack_from(std::byte* bytes, const class_type& value)
+    {
+        Packing::pack(bytes, static_cast<typename Packing::value_type>(value.*Member));
+    }
+
+    [[nodiscard]] static auto is_valid(const class_type& value) -> bool
+    {
+        return detail::_is_valid<Packing>(static_cast<typename Packing::value_type>(value.*Member));
+    }
+};
+
+// Packs or unpacks the given fields of T in sequence, directly from and into the data members of T,
+// without going through a tuple. The fields are packed in the order they are given, which need not
+// be the order of the data members.
+template <std::default_initializable T, class... Fields> struct struct_packing
+{
+    static_assert(sizeof...(Fields) > 0);
+    static_assert((std::same_as<typename Fields::class_type, T> && ...));
+    using value_type = T;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes) -> T
+    {
+        T value{};
+        std::size_t offset = 0;
+        ((Fields::unpack_into(bytes + offset, value), offset += Fields::packing::size()), ...);
+        return value;
+    }
+
+    static void pack(std::byte* bytes, const T& value)
+    {
+        std::size_t offset = 0;
+        ((Fields::pack_from(bytes + offset, value), offset += Fields::packing::size()), ...);
+    }
+
+    // Whether each field is valid according to its packing.
+    [[nodiscard]] static auto is_valid(const T& value) -> bool
+    requires(validating_byte_packing<typename Fields::packing> || ...)
+    {
+        return (Fields::is_valid(value) && ...);
+    }
+
+    [[nodiscard]] static constexpr auto size()
+    {
+        return (Fields::packing::size() + ...);
+    }
+};
+
+namespace detail {
+
+// Converts the unpacked value to whatever type the aggregate member has upon initialization.
+template <class V> struct _converting
+{
+    V value;
+
+    template <class U> operator U() const
+    {
+        return static_cast<U>(value);
+    }
+};
+
+// Binds references to the N data members of the aggregate T, in declaration order.
+template <std::size_t N, class T> auto _tie_members(T& value)
+{
+    // clang-format off
+    if constexpr (N == 1) { auto& [a] = value; return std::tie(a); }
+    else if constexpr (N == 2) { auto& [a, b] = value; return std::tie(a, b); }
+    else if constexpr (N == 3) { auto& [a, b, c] = value; return std::tie(a, b, c); }
+    else if constexpr (N == 4) { auto& [a, b, c, d] = value; return std::tie(a, b, c, d); }
+    else if constexpr (N == 5) { auto& [a, b, c, d, e] = value; return std::tie(a, b, c, d, e); }
+    else if constexpr (N == 6) { auto& [a, b, c, d, e, f] = value; return std::tie(a, b, c, d, e, f); }
+    else if constexpr (N == 7) { auto& [a, b, c, d, e, f, g] = value; return std::tie(a, b, c, d, e, f, g); }
+    else if constexpr (N == 8) { auto& [a, b, c, d, e, f, g, h] = value; return std::tie(a, b, c, d, e, f, g, h); }
+    else if constexpr (N == 9) { auto& [a, b, c, d, e, f, g, h, i] = value; return std::tie(a, b, c, d, e, f, g, h, i); }
+    else if constexpr (N == 10) { auto& [a, b, c, d, e, f, g, h, i, j] = value; return std::tie(a, b, c, d, e, f, g, h, i, j); }
+    else if constexpr (N == 11) { auto& [a, b, c, d, e, f, g, h, i, j, k] = value; return std::tie(a, b, c, d, e, f, g, h, i, j, k); }
+    else if constexpr (N == 12) { auto& [a, b, c, d, e, f, g, h, i, j, k, l] = value; return std::tie(a, b, c, d, e, f, g, h, i, j, k, l); }
+    else if constexpr (N == 13) { auto& [a, b, c, d, e, f, g, h, i, j, k, l, m] = value; return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m); }
+    else if constexpr (N == 14) { auto& [a, b, c, d, e, f, g, h, i, j, k, l, m, n] = value; return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m, n); }
+    else if constexpr (N == 15) { auto& [a, b, c, d, e, f, g, h, i, j, k, l, m, n, o] = value; return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o); }
+    else if constexpr (N == 16) { auto& [a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p] = value; return std::tie(a, b, c, d, e, f, g, h, i, j, k, l, m, n, o, p); }
+    else { static_assert(N <= 16, "aggregate_packing supports at most 16 members"); }
+    // clang-format on
+}
+
+template <byte_packing... Packings, class Tuple, std::size_t... Indices>
+void _pack_members(std::byte* bytes, const Tuple& members, std::index_sequence<Indices...>)
+{
+    std::size_t offset = 0;
+    ((Packings::pack(bytes + offset,
+                     static_cast<typename Packings::value_type>(std::get<Indices>(members))),
+      offset += Packings::size()),
+     ...);
+}
+
+template <byte_packing... Packings, class Tuple, std::size_t... Indices>
+[[nodiscard]] auto _valid_members(const Tuple& members, std::index_sequence<Indices...>) -> bool
+{
+    return (_is_valid<Packings>(
+                static_cast<typename Packings::value_type>(std::get<Indices>(members))) &&
+            ...);
+}
+
+} // namespace detail
+
+// Packs or unpacks all data members of the aggregate T in declaration order, one packing per data
+// member. Unlike struct_packing, the members need not be named, but there must be exactly one
+// packing for each of them (at most 16) and T must not have base classes.
+template <class T, byte_packing... Packings>
+requires std::is_aggregate_v<T>
+struct aggregate_packing
+{
+    static_assert(sizeof...(Packings) > 0);
+    using value_type = T;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes) -> T
+    {
+        std::size_t offset = 0;
+        // Initializer clauses in braces are evaluated in order, so are the offsets.
+        return T{detail::_converting<typename Packings::value_type>{
+            Packings::unpack(bytes + std::exchange(offset, offset + Packings::size()))}...};
+    }
+
+    static void pack(std::byte* bytes, const T& value)
+    {
+        detail::_pack_members<Packings...>(
+            bytes, detail::_tie_members<sizeof...(Packings)>(value),
+            std::index_sequence_for<Packings...>{});
+    }
+
+    // Whether each data member is valid according to its packing.
+    [[nodiscard]] static auto is_valid(const T& value) -> bool
+    requires(validating_byte_packing<Packings> || ...)
+    {
+        return detail::_valid_members<Packings...>(detail::_tie_members<sizeof...(Packings)>(value),
+                                                   std::index_sequence_for<Packings...>{});
+    }
+
+    [[nodiscard]] static constexpr auto size()
+    {
+        return (Packings::size() + ...);
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Packing of singular type
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <byte_packing Packing, byte_range Bytes>
+[[nodiscard]] auto unpack(const Bytes& bytes, std::size_t offset) -> typename Packing::value_type
+{
+    return Packing::unpack(std::ranges::cdata(bytes) + offset);
+}
+
+template <byte_packing Packing, class U, writable_byte_range Bytes>
+void pack(Bytes& bytes, std::size_t offset, const U& value)
+{
+    Packing::pack(std::ranges::data(bytes) + offset, typename Packing::value_type(value));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Compound packing (multiple types, multiple values of same type)
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Pseudo packings among Packings are skipped, so there is one value for each other packing.
+template <detail::_tuple_element... Packings, byte_range Bytes>
+[[nodiscard]] auto unpack_tuple(const Bytes& bytes, std::size_t offset)
+{
+    return unpack<tuple_packing<Packings...>>(bytes, offset);
+}
+
+template <detail::_tuple_element... Packings, writable_byte_range Bytes, class... Values>
+requires(sizeof...(Values) == std::tuple_size_v<typename tuple_packing<Packings...>::value_type>)
+void pack_tuple(Bytes& bytes, std::size_t offset, const Values&... values)
+{
+    tuple_packing<Packings...>::pack(std::ranges::data(bytes) + offset, values...);
+}
+
+// Unpacks multiple values in sequence directly into the given variables, converting each value to
+// the variable's type using static_cast.
+template <byte_packing... Packings, byte_range Bytes, class... Outputs>
+requires(sizeof...(Packings) == sizeof...(Outputs))
+void unpack_into(const Bytes& bytes, std::size_t offset, Outputs&... outputs)
+{
+    auto const* data = std::ranges::cdata(bytes) + offset;
+    ((outputs = static_cast<Outputs>(Packings::unpack(data)), data += Packings::size()), ...);
+}
+
+namespace detail {
+
+// Whether the values of Packing can be unpacked from or packed into the given contiguous iterator's
+// storage with a single call to the packing's bulk methods.
+template <class Packing, class Iterator>
+concept _bulk_iterator = bulk_byte_packing<Packing> && std::contiguous_iterator<Iterator> &&
+                         std::same_as<std::iter_value_t<Iterator>, typename Packing::value_type>;
+
+template <class Packing, class Range>
+concept _bulk_range =
+    bulk_byte_packing<Packing> && std::ranges::contiguous_range<Range> &&
+    std::same_as<std::ranges::range_value_t<Range>, typename Packing::value_type>;
+
+// Packs all values of range one after another, at once if possible.
+template <byte_packing Packing, std::ranges::range Range>
+void _pack_all(std::byte* bytes, const Range& range)
+{
+    if constexpr (_bulk_range<Packing, Range>)
+    {
+        Packing::pack_range(bytes, std::ranges::data(range), std::ranges::size(range));
+    }
+    else
+    {
+        for (auto const& value : range)
+        {
+            Packing::pack(bytes, typename Packing::value_type(value));
+            bytes += Packing::size();
+        }
+    }
+}
+
+} // namespace detail
+
+// Unpacks n values into the given output iterator. If the packing is a bulk_byte_packing and the
+// output is contiguous, all values are unpacked at once.
+template <byte_packing Packing, byte_range Bytes, class Iterator>
+requires std::output_iterator<Iterator, typename Packing::value_type>
+auto unpack_range(const Bytes& bytes, std::size_t offset, Iterator first, std::size_t count)
+    -> Iterator
+{
+    if constexpr (detail::_bulk_iterator<Packing, Iterator>)
+    {
+        Packing::unpack_range(std::ranges::cdata(bytes) + offset, std::to_address(first), count);
+        return first + static_cast<std::iter_difference_t<Iterator>>(count);
+    }
+    else
+    {
+        for (decltype(count) i = 0; i < count; ++i)
+        {
+            *first++ = unpack<Packing>(bytes, offset);
+            offset += Packing::size();
+        }
+        return first;
+    }
+}
+
+template <byte_packing Packing, writable_byte_range Bytes, std::input_iterator Iterator>
+void pack_range(Bytes& bytes, std::size_t offset, Iterator first, Iterator last)
+{
+    if constexpr (detail::_bulk_iterator<Packing, Iterator>)
+    {
+        Packing::pack_range(std::ranges::data(bytes) + offset, std::to_address(first),
+                            static_cast<std::size_t>(last - first));
+    }
+    else
+    {
+        while (first != last)
+        {
+            pack<Packing>(bytes, offset, *first++);
+            offset += Packing::size();
+        }
+    }
+}
+
+template <byte_packing Packing, writable_byte_range Bytes, std::ranges::range Range>
+void pack_range(Bytes& bytes, std::size_t offset, const Range& range)
+{
+    detail::_pack_all<Packing>(std::ranges::data(bytes) + offset, range);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Records (arrays of tuples) and columns
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// Describes packings whose packed bytes are the bytes of the value, possibly in reverse order. A
+// column of such values can be gathered from records as raw bytes and then swapped in place.
+template <class Packing> struct _byte_image
+{
+    static constexpr bool value = false;
+};
+
+template <std::integral T> struct _byte_image<_little_endian_ptrcast<T>>
+{
+    static constexpr bool value = true;
+    static constexpr bool swapped = false;
+};
+
+template <std::integral T> struct _byte_image<_big_endian_ptrcast<T>>
+{
+    static constexpr bool value = true;
+    static constexpr bool swapped = sizeof(T) > 1;
+};
+
+template <std::floating_point T, std::endian Order> struct _byte_image<_floating_point<T, Order>>
+{
+    static constexpr bool value = true;
+    static constexpr bool swapped = Order != std::endian::native;
+};
+
+template <class T>
+requires std::is_trivially_copyable_v<T>
+struct _byte_image<raw<T>>
+{
+    static constexpr bool value = true;
+    static constexpr bool swapped = false;
+};
+
+template <byte_packing Packing>
+void _unpack_column(const std::byte* bytes, std::size_t stride, std::size_t count,
+                    typename Packing::value_type* column)
+{
+    using value_type = typename Packing::value_type;
+    if constexpr (_byte_image<Packing>::value)
+    {
+        auto* dest = reinterpret_cast<std::byte*>(column);
+        gather_strided_bytes<sizeof(value_type)>(dest, bytes, stride, count);
+        if constexpr (_byte_image<Packing>::swapped)
+        {
+            copy_swapped_bytes<sizeof(value_type)>(dest, dest, count);
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < count; ++i, bytes += stride)
+        {
+            column[i] = Packing::unpack(bytes);
+        }
+    }
+}
+
+template <byte_packing Packing>
+void _pack_column(std::byte* bytes, std::size_t stride, std::size_t count,
+                  const typename Packing::value_type* column)
+{
+    for (std::size_t i = 0; i < count; ++i, bytes += stride)
+    {
+        Packing::pack(bytes, column[i]);
+    }
+}
+
+} // namespace detail
+
+// Unpacks consecutive records, each packed as tuple_packing<Packings...>, into one column per
+// field. Unpacks as many records as the shortest column holds. Instead of unpacking record by
+// record, each field is gathered from all records at once (with vector gathers for 4- and 8-byte
+// fields where available), which suits columnar processing.
+template <byte_packing... Packings, byte_range Bytes>
+void unpack_records(const Bytes& bytes, std::size_t offset,
+                    std::span<typename Packings::value_type>... columns)
+{
+    using plan = detail::_tuple_plan<Packings...>;
+    constexpr auto stride = tuple_packing<Packings...>::size();
+    auto const count = std::min({columns.size()...});
+    auto const* data = std::ranges::cdata(bytes) + offset;
+    [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+        (detail::_unpack_column<Packings>(data + plan::offsets[Indices], stride, count,
+                                          columns.data()),
+         ...);
+    }(std::index_sequence_for<Packings...>{});
+}
+
+// Unpacks count consecutive records into a tuple of one std::vector per field.
+template <byte_packing... Packings, byte_range Bytes>
+[[nodiscard]] auto unpack_records(const Bytes& bytes, std::size_t offset, std::size_t count)
+    -> std::tuple<std::vector<typename Packings::value_type>...>
+{
+    std::tuple<std::vector<typename Packings::value_type>...> columns{
+        std::vector<typename Packings::value_type>(count)...};
+    std::apply(
+        [&](auto&... column) { unpack_records<Packings...>(bytes, offset, std::span{column}...); },
+        columns);
+    return columns;
+}
+
+// The inverse of unpack_records: packs the i-th values of all columns as the i-th record, for as
+// many records as the shortest column holds.
+template <byte_packing... Packings, writable_byte_range Bytes>
+void pack_records(Bytes& bytes, std::size_t offset,
+                  std::span<const typename Packings::value_type>... columns)
+{
+    using plan = detail::_tuple_plan<Packings...>;
+    constexpr auto stride = tuple_packing<Packings...>::size();
+    auto const count = std::min({columns.size()...});
+    auto* data = std::ranges::data(bytes) + offset;
+    [&]<std::size_t... Indices>(std::index_sequence<Indices...>) {
+        (detail::_pack_column<Packings>(data + plan::offsets[Indices], stride, count,
+                                        columns.data()),
+         ...);
+    }(std::index_sequence_for<Packings...>{});
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Terminated strings
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Returns the offset of the first terminator at or after offset, or the size of bytes if there is
+// none. Scans 16 to 64 bytes at a time using the active simd_level.
+template <byte_range Bytes>
+[[nodiscard]] auto find_terminator(const Bytes& bytes, std::size_t offset,
+                                   std::byte terminator = std::byte{0}) -> std::size_t
+{
+    auto const size = std::ranges::size(bytes);
+    if (offset >= size)
+    {
+        return size;
+    }
+    return offset + find_byte(std::ranges::cdata(bytes) + offset, size - offset, terminator);
+}
+
+// Unpacks the string starting at offset and ending before the next terminator (or at the end of
+// bytes if there is none). Returns a view of the bytes rather than a copy.
+template <byte_range Bytes>
+[[nodiscard]] auto unpack_cstring(const Bytes& bytes, std::size_t offset,
+                                  std::byte terminator = std::byte{0}) -> std::string_view
+{
+    // An offset at or past the end yields an empty string rather than a wrapped-around size.
+    if (offset >= std::ranges::size(bytes))
+    {
+        return {};
+    }
+    auto const end = find_terminator(bytes, offset, terminator);
+    return {reinterpret_cast<const char*>(std::ranges::cdata(bytes) + offset), end - offset};
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Checked unpacking
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Describes why a checked unpack failed.
+enum class unpack_error
+{
+    // The bytes end before the unpacked values do.
+    out_of_bounds,
+    // An unpacked value is invalid according to its packing (see validating_byte_packing).
+    invalid_value,
+    // The bytes differ from the constant bytes of the packing (see signature_packing).
+    mismatch,
+};
+
+namespace detail {
+
+// Whether size bytes starting at offset lie within length bytes (without overflowing).
+[[nodiscard]] constexpr auto _in_bounds(std::size_t length, std::size_t offset,
+                                        std::size_t size) noexcept -> bool
+{
+    return offset <= length && size <= length - offset;
+}
+
+// A packing that checks constant bytes: a signature_packing or a tuple_packing containing one.
+template <class Packing>
+concept _matching = _tuple_element<Packing> && requires(const std::byte* bytes) {
+    { Packing::matches(bytes) } -> std::same_as<bool>;
+};
+
+} // namespace detail
+
+// Whether the constant bytes of Packing (see signature_packing) match bytes at offset. Returns
+// false if the packing does not fit into bytes. Scanning for a header this way rejects most offsets
+// with a single comparison, without unpacking anything.
+template <detail::_matching Packing, byte_range Bytes>
+[[nodiscard]] auto matches(const Bytes& bytes, std::size_t offset) -> bool
+{
+    return detail::_in_bounds(std::ranges::size(bytes), offset, detail::_size_at<Packing>(0)) &&
+           Packing::matches(std::ranges::cdata(bytes) + offset);
+}
+
+// Like unpack, but returns unpack_error::out_of_bounds instead of reading past the end of bytes,
+// unpack_error::mismatch if the constant bytes of the packing differ, and
+// unpack_error::invalid_value if the packing rejects the unpacked value.
+template <byte_packing Packing, byte_range Bytes>
+[[nodiscard]] auto try_unpack(const Bytes& bytes, std::size_t offset)
+    -> std::expected<typename Packing::value_type, unpack_error>
+{
+    if (!detail::_in_bounds(std::ranges::size(bytes), offset, Packing::size())) [[unlikely]]
+    {
+        return std::unexpected{unpack_error::out_of_bounds};
+    }
+    if constexpr (detail::_matching<Packing>)
+    {
+        if (!Packing::matches(std::ranges::cdata(bytes) + offset)) [[unlikely]]
+        {
+            return std::unexpected{unpack_error::mismatch};
+        }
+    }
+    auto value = unpack<Packing>(bytes, offset);
+    if (!detail::_is_valid<Packing>(value)) [[unlikely]]
+    {
+        return std::unexpected{unpack_error::invalid_value};
+    }
+    return value;
+}
+
+// Like unpack_tuple, but checks the bounds of the whole tuple at once.
+template <detail::_tuple_element... Packings, byte_range Bytes>
+[[nodiscard]] auto try_unpack_tuple(const Bytes& bytes, std::size_t offset)
+{
+    return try_unpack<tuple_packing<Packings...>>(bytes, offset);
+}
+
+// Like unpack_range, but checks the bounds of all count values at once. Nothing is written to the
+// output iterator if they do not fit. Values of validating (or matching) packings are checked one
+// by one before they are written, so the values preceding an invalid one are written.
+template <byte_packing Packing, byte_range Bytes, class Iterator>
+requires std::output_iterator<Iterator, typename Packing::value_type>
+[[nodiscard]] auto try_unpack_range(const Bytes& bytes, std::size_t offset, Iterator first,
+                                    std::size_t count) -> std::expected<Iterator, unpack_error>
+{
+    auto const length = std::ranges::size(bytes);
+    // Dividing rather than multiplying cannot overflow.
+    if (offset > length || (Packing::size() != 0 && count > (length - offset) / Packing::size()))
+        [[unlikely]]
+    {
+        return std::unexpected{unpack_error::out_of_bounds};
+    }
+    if constexpr (validating_byte_packing<Packing> || detail::_matching<Packing>)
+    {
+        auto const* data = std::ranges::cdata(bytes) + offset;
+        for (std::size_t i = 0; i < count; ++i, ++first)
+        {
+            if constexpr (detail::_matching<Packing>)
+            {
+                if (!Packing::matches(data + i * Packing::size())) [[unlikely]]
+                {
+                    return std::unexpected{unpack_error::mismatch};
+                }
+            }
+            auto value = Packing::unpack(data + i * Packing::size());
+            if (!detail::_is_valid<Packing>(value)) [[unlikely]]
+            {
+                return std::unexpected{unpack_error::invalid_value};
+            }
+            *first = std::move(value);
+        }
+        return first;
+    }
+    else
     {
-        pack<Packing>(bytes, offset, value);
-        offset += Packing::size();
+        return unpack_range<Packing>(bytes, offset, first, count);
     }
 }
 
@@ -0,0 +1,243 @@
+#pragma once
+
+#include "concepts.h"
+#include "packing.h"
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <mutex>
+#include <numeric>
+#include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace dualis {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Parallel packing
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Describes how the parallel overloads of unpack_range and pack_range split their work: into
+// chunks of chunk_size bytes (rounded down to whole values), processed by up to threads threads,
+// including the calling one. Less than threshold bytes are processed serially, since starting
+// threads costs more than it saves.
+//
+// The chunks depend only on the number of values and on chunk_size, never on the number of
+// threads, so the results are the same as those of the serial functions.
+struct parallel_policy
+{
+    unsigned threads = std::max(std::thread::hardware_concurrency(), 1u);
+    std::size_t chunk_size = std::size_t{1} << 18;
+    std::size_t threshold = std::size_t{1} << 20;
+};
+
+namespace detail {
+
+// Calls f(i) for each i below count, distributing the calls over the threads of policy. Rethrows
+// the first exception thrown by f after all threads have finished; no more calls are started once
+// f has thrown.
+template <class F> void _parallel_for(const parallel_policy& policy, std::size_t count, F&& f)
+{
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto const work = [&] {
+        try
+        {
+            for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < count;
+                 i = next.fetch_add(1, std::memory_order_relaxed))
+            {
+                f(i);
+            }
+        }
+        catch (...)
+        {
+            std::lock_guard const lock{error_mutex};
+            if (!error)
+            {
+                error = std::current_exception();
+            }
+            next.store(count, std::memory_order_relaxed);
+        }
+    };
+
+    {
+        auto const thread_count = std::min<std::size_t>(std::max(policy.threads, 1u), count);
+        std::vector<std::jthread> threads;
+        threads.reserve(thread_count - 1);
+        for (std::size_t i = 1; i < thread_count; ++i)
+        {
+            threads.emplace_back(work);
+        }
+        work();
+    }
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+// The number of values of Packing in each chunk of a parallel operation on count values, or 0 if
+// the values should be processed serially.
+template <byte_packing Packing>
+[[nodiscard]] auto _chunk_length(const parallel_policy& policy, std::size_t count) -> std::size_t
+{
+    auto const length = std::max<std::size_t>(policy.chunk_size / Packing::size(), 1);
+    if (policy.threads <= 1 || count <= length || count < policy.threshold / Packing::size())
+    {
+        return 0;
+    }
+    return length;
+}
+
+} // namespace detail
+
+// Like unpack_range, but unpacks chunks of the values on multiple threads (see parallel_policy).
+template <byte_packing Packing, byte_range Bytes, std::random_access_iterator Iterator>
+requires std::output_iterator<Iterator, typename Packing::value_type>
+auto unpack_range(const parallel_policy& policy, const Bytes& bytes, std::size_t offset,
+                  Iterator first, std::size_t count) -> Iterator
+{
+    auto const length = detail::_chunk_length<Packing>(policy, count);
+    if (length == 0)
+    {
+        return unpack_range<Packing>(bytes, offset, first, count);
+    }
+    detail::_parallel_for(policy, (count + length - 1) / length, [&](std::size_t chunk) {
+        auto const begin = chunk * length;
+        unpack_range<Packing>(bytes, offset + begin * Packing::size(),
+                              first + static_cast<std::iter_difference_t<Iterator>>(begin),
+                              std::min(length, count - begin));
+    });
+    return first + static_cast<std::iter_difference_t<Iterator>>(count);
+}
+
+// Like pack_range, but packs chunks of the values on multiple threads (see parallel_policy).
+template <byte_packing Packing, writable_byte_range Bytes, std::random_access_iterator Iterator>
+void pack_range(const parallel_policy& policy, Bytes& bytes, std::size_t offset, Iterator first,
+                Iterator last)
+{
+    auto const count = static_cast<std::size_t>(last - first);
+    auto const length = detail::_chunk_length<Packing>(policy, count);
+    if (length == 0)
+    {
+        pack_range<Packing>(bytes, offset, first, last);
+        return;
+    }
+    detail::_parallel_for(policy, (count + length - 1) / length, [&](std::size_t chunk) {
+        auto const begin = chunk * length;
+        auto const chunk_first = first + static_cast<std::iter_difference_t<Iterator>>(begin);
+        auto const chunk_last = chunk_first + static_cast<std::iter_difference_t<Iterator>>(
+                                                  std::min(length, count - begin));
+        pack_range<Packing>(bytes, offset + begin * Packing::size(), chunk_first, chunk_last);
+    });
+}
+
+template <byte_packing Packing, writable_byte_range Bytes, std::ranges::random_access_range Range>
+requires std::ranges::common_range<Range>
+void pack_range(const parallel_policy& policy, Bytes& bytes, std::size_t offset,
+                const Range& range)
+{
+    pack_range<Packing>(policy, bytes, offset, std::ranges::begin(range), std::ranges::end(range));
+}
+
+namespace detail {
+
+// A container of bytes that can grow, such as byte_container or std::vector<std::byte>.
+template <class Container>
+concept _resizable_bytes = requires(Container& container, std::size_t size) {
+    container.resize(size);
+    { container.data() } -> std::same_as<std::byte*>;
+    { container.size() } -> std::convertible_to<std::size_t>;
+};
+
+// Packs the values [first, last) one after another with the variable-size Packing into bytes.
+template <variable_byte_packing Packing, class Iterator>
+void _pack_variable_range(std::byte* bytes, Iterator first, Iterator last)
+{
+    for (; first != last; ++first)
+    {
+        bytes += Packing::pack(bytes, typename Packing::value_type(*first));
+    }
+}
+
+// The number of bytes the values [first, last) take when packed with Packing.
+template <variable_byte_packing Packing, class Iterator>
+[[nodiscard]] auto _packed_range_size(Iterator first, Iterator last) -> std::size_t
+{
+    std::size_t size = 0;
+    for (; first != last; ++first)
+    {
+        size += Packing::size(typename Packing::value_type(*first));
+    }
+    return size;
+}
+
+} // namespace detail
+
+// Appends the values of range, each packed with the variable-size Packing (e.g. a varint or
+// length_prefixed), to bytes. Measures all values first so that bytes grows only once. Returns the
+// number of bytes appended.
+template <variable_byte_packing Packing, detail::_resizable_bytes Container,
+          std::ranges::forward_range Range>
+auto append_varint_range(Container& bytes, const Range& range) -> std::size_t
+{
+    auto const first = std::ranges::begin(range);
+    auto const last = std::ranges::end(range);
+    auto const offset = static_cast<std::size_t>(bytes.size());
+    auto const size = detail::_packed_range_size<Packing>(first, last);
+    bytes.resize(offset + size);
+    detail::_pack_variable_range<Packing>(bytes.data() + offset, first, last);
+    return size;
+}
+
+// Like append_varint_range, but packs chunks of the values on multiple threads (see
+// parallel_policy; the chunks are chunk_size bytes of values before packing). Since the offset of
+// each packed value depends on the sizes of all preceding ones, the chunks are measured in
+// parallel first; the prefix sums of their sizes are then the offsets at which the chunks are
+// packed in parallel, after bytes has grown once.
+template <variable_byte_packing Packing, detail::_resizable_bytes Container,
+          std::ranges::random_access_range Range>
+auto append_varint_range(const parallel_policy& policy, Container& bytes, const Range& range)
+    -> std::size_t
+{
+    using value_type = std::ranges::range_value_t<Range>;
+    auto const count = static_cast<std::size_t>(std::ranges::size(range));
+    auto const length = std::max<std::size_t>(policy.chunk_size / sizeof(value_type), 1);
+    if (policy.threads <= 1 || count <= length || count < policy.threshold / sizeof(value_type))
+    {
+        return append_varint_range<Packing>(bytes, range);
+    }
+
+    auto const chunk_count = (count + length - 1) / length;
+    auto const chunk = [&](std::size_t index) {
+        auto const first = std::ranges::begin(range) +
+                           static_cast<std::ranges::range_difference_t<Range>>(index * length);
+        return std::pair{first, first + static_cast<std::ranges::range_difference_t<Range>>(
+                                            std::min(length, count - index * length))};
+    };
+
+    // The offset of each chunk relative to the first, followed by the size of all of them.
+    std::vector<std::size_t> offsets(chunk_count + 1);
+    detail::_parallel_for(policy, chunk_count, [&](std::size_t index) {
+        auto const [first, last] = chunk(index);
+        offsets[index + 1] = detail::_packed_range_size<Packing>(first, last);
+    });
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    auto const offset = static_cast<std::size_t>(bytes.size());
+    bytes.resize(offset + offsets.back());
+    auto* const data = bytes.data() + offset;
+    detail::_parallel_for(policy, chunk_count, [&](std::size_t index) {
+        auto const [first, last] = chunk(index);
+        detail::_pack_variable_range<Packing>(data + offsets[index], first, last);
+    });
+    return offsets.back();
+}
+
+} // namespace dualis
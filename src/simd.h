@@ -0,0 +1,734 @@
+#pragma once
+
+#include "utilities.h"
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define _DUALIS_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// Kernels for instruction sets beyond the baseline are compiled using function attributes, which
+// allows selecting them at runtime. MSVC does not need (or support) these attributes.
+#if defined(__GNUC__) || defined(__clang__)
+#define _DUALIS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define _DUALIS_TARGET(isa)
+#endif
+
+namespace dualis {
+
+// The instruction set extensions used by the vectorized kernels, in ascending order.
+enum class simd_level
+{
+    scalar,
+    sse2,
+    ssse3,
+    avx2,
+    avx512,
+};
+
+[[nodiscard]] constexpr auto simd_level_name(simd_level level) -> std::string_view
+{
+    switch (level)
+    {
+    case simd_level::sse2: return "sse2";
+    case simd_level::ssse3: return "ssse3";
+    case simd_level::avx2: return "avx2";
+    case simd_level::avx512: return "avx512";
+    default: return "scalar";
+    }
+}
+
+// Queries the CPU (and, for AVX, the operating system) for the highest supported simd_level.
+[[nodiscard]] inline auto detect_simd_level() -> simd_level
+{
+#if defined(_DUALIS_X86) && (defined(__GNUC__) || defined(__clang__))
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw"))
+    {
+        return simd_level::avx512;
+    }
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return simd_level::avx2;
+    }
+    if (__builtin_cpu_supports("ssse3"))
+    {
+        return simd_level::ssse3;
+    }
+    return __builtin_cpu_supports("sse2") ? simd_level::sse2 : simd_level::scalar;
+#elif defined(_DUALIS_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    auto const max_leaf = info[0];
+    __cpuid(info, 1);
+    auto const sse2 = (info[3] & (1 << 26)) != 0;
+    auto const ssse3 = (info[2] & (1 << 9)) != 0;
+    auto const os_avx = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x06) == 0x06;
+    auto const os_avx512 = os_avx && (_xgetbv(0) & 0xe6) == 0xe6;
+    bool avx2 = false, avx512 = false;
+    if (max_leaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        avx2 = os_avx && (info[1] & (1 << 5)) != 0;
+        avx512 = os_avx512 && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+    }
+    return avx512 ? simd_level::avx512
+           : avx2 ? simd_level::avx2
+           : ssse3 ? simd_level::ssse3
+           : sse2 ? simd_level::sse2
+                  : simd_level::scalar;
+#else
+    return simd_level::scalar;
+#endif
+}
+
+namespace detail {
+
+//== byte swapping ================================================================================
+
+// Shuffle control mask that reverses the order of the bytes within each element of the given width.
+// It is 64 bytes long so it can be loaded into registers of any width (the pattern repeats every
+// 16 bytes, which means it also works for the lane-wise shuffles of AVX2 and AVX-512).
+template <std::size_t Width> constexpr auto _make_byte_swap_shuffle() -> std::array<uint8_t, 64>
+{
+    std::array<uint8_t, 64> shuffle{};
+    for (std::size_t i = 0; i < shuffle.size(); ++i)
+    {
+        shuffle[i] = static_cast<uint8_t>((i % 16) / Width * Width + (Width - 1 - i % Width));
+    }
+    return shuffle;
+}
+
+template <std::size_t Width>
+alignas(64) inline constexpr auto _byte_swap_shuffle = _make_byte_swap_shuffle<Width>();
+
+template <std::size_t Width>
+void _copy_swapped_scalar(std::byte* dest, const std::byte* src, std::size_t count)
+{
+    using T = unsigned_int<Width>;
+    for (std::size_t i = 0; i < count; ++i, dest += Width, src += Width)
+    {
+        T value;
+        copy_bytes(reinterpret_cast<std::byte*>(&value), src, Width);
+        value = byte_swap(value);
+        copy_bytes(dest, reinterpret_cast<const std::byte*>(&value), Width);
+    }
+}
+
+#ifdef _DUALIS_X86
+// SSE2 lacks a byte shuffle, so the bytes are swapped using word shuffles and shifts instead.
+template <std::size_t Width>
+_DUALIS_TARGET("sse2")
+[[nodiscard]] inline auto _byte_swap_sse2(__m128i value) -> __m128i
+{
+    if constexpr (Width >= 4)
+    {
+        // Reverse the order of the 16-bit words within each 32-bit element.
+        value = _mm_shufflelo_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+        value = _mm_shufflehi_epi16(value, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+    if constexpr (Width == 8)
+    {
+        // Reverse the order of the 32-bit halves within each 64-bit element.
+        value = _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1));
+    }
+    return _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+}
+
+template <std::size_t Width>
+_DUALIS_TARGET("sse2")
+void _copy_swapped_sse2(std::byte* dest, const std::byte* src, std::size_t count)
+{
+    auto const size = count * Width;
+    std::size_t offset = 0;
+    for (; offset + 16 <= size; offset += 16)
+    {
+        auto const value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + offset), _byte_swap_sse2<Width>(value));
+    }
+    _copy_swapped_scalar<Width>(dest + offset, src + offset, (size - offset) / Width);
+}
+
+template <std::size_t Width>
+_DUALIS_TARGET("ssse3")
+void _copy_swapped_ssse3(std::byte* dest, const std::byte* src, std::size_t count)
+{
+    auto const shuffle =
+        _mm_load_si128(reinterpret_cast<const __m128i*>(_byte_swap_shuffle<Width>.data()));
+    auto const size = count * Width;
+    std::size_t offset = 0;
+    for (; offset + 16 <= size; offset += 16)
+    {
+        auto const value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + offset),
+                         _mm_shuffle_epi8(value, shuffle));
+    }
+    _copy_swapped_scalar<Width>(dest + offset, src + offset, (size - offset) / Width);
+}
+
+template <std::size_t Width>
+_DUALIS_TARGET("avx2")
+void _copy_swapped_avx2(std::byte* dest, const std::byte* src, std::size_t count)
+{
+    auto const shuffle =
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(_byte_swap_shuffle<Width>.data()));
+    auto const size = count * Width;
+    std::size_t offset = 0;
+    // Two independent shuffles per iteration hide the latency of the loads.
+    for (; offset + 64 <= size; offset += 64)
+    {
+        auto const* in = reinterpret_cast<const __m256i*>(src + offset);
+        auto* out = reinterpret_cast<__m256i*>(dest + offset);
+        auto const value0 = _mm256_loadu_si256(in);
+        auto const value1 = _mm256_loadu_si256(in + 1);
+        _mm256_storeu_si256(out, _mm256_shuffle_epi8(value0, shuffle));
+        _mm256_storeu_si256(out + 1, _mm256_shuffle_epi8(value1, shuffle));
+    }
+    for (; offset + 32 <= size; offset += 32)
+    {
+        auto const value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + offset));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + offset),
+                            _mm256_shuffle_epi8(value, shuffle));
+    }
+    _copy_swapped_scalar<Width>(dest + offset, src + offset, (size - offset) / Width);
+}
+
+template <std::size_t Width>
+_DUALIS_TARGET("avx512f,avx512bw")
+void _copy_swapped_avx512(std::byte* dest, const std::byte* src, std::size_t count)
+{
+    auto const shuffle = _mm512_load_si512(_byte_swap_shuffle<Width>.data());
+    auto const size = count * Width;
+    std::size_t offset = 0;
+    for (; offset + 64 <= size; offset += 64)
+    {
+        auto const value = _mm512_loadu_si512(src + offset);
+        _mm512_storeu_si512(dest + offset, _mm512_shuffle_epi8(value, shuffle));
+    }
+    // The remainder is handled by masked loads and stores instead of a scalar loop.
+    if (offset < size)
+    {
+        auto const mask = static_cast<__mmask64>((1ULL << (size - offset)) - 1);
+        auto const value = _mm512_maskz_loadu_epi8(mask, src + offset);
+        _mm512_mask_storeu_epi8(dest + offset, mask, _mm512_shuffle_epi8(value, shuffle));
+    }
+}
+#endif
+
+//== base64 =======================================================================================
+
+inline constexpr char _base64_digits[65] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Encodes complete groups of three bytes into four base64 digits each. Returns the number of
+// bytes consumed; the caller is responsible for the remaining bytes (and padding).
+inline auto _encode_base64_scalar(char* dest, const uint8_t* src, std::size_t length) -> std::size_t
+{
+    std::size_t offset = 0;
+    for (; offset + 3 <= length; offset += 3, dest += 4)
+    {
+        uint32_t const group = (src[offset] << 16) | (src[offset + 1] << 8) | src[offset + 2];
+        dest[0] = _base64_digits[(group >> 18) & 0x3f];
+        dest[1] = _base64_digits[(group >> 12) & 0x3f];
+        dest[2] = _base64_digits[(group >> 6) & 0x3f];
+        dest[3] = _base64_digits[group & 0x3f];
+    }
+    return offset;
+}
+
+#ifdef _DUALIS_X86
+// The following follows the vectorized base64 encoding described by Wojciech Muła and Daniel
+// Lemire in "Faster Base64 Encoding and Decoding Using AVX2 Instructions" (2018). Each 128-bit lane
+// turns 12 input bytes (in its lowest 12 bytes) into 16 base64 digits.
+_DUALIS_TARGET("ssse3")
+[[nodiscard]] inline auto _base64_split_ssse3(__m128i in) -> __m128i
+{
+    // Arrange the bytes [a b c] of each group as [b a c b] so that each 32-bit lane contains all
+    // four 6-bit indices, then move each of them into its own byte using multiplies as shifts.
+    in = _mm_shuffle_epi8(in, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    auto const t0 = _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00));
+    auto const t1 = _mm_mulhi_epu16(t0, _mm_set1_epi32(0x04000040));
+    auto const t2 = _mm_and_si128(in, _mm_set1_epi32(0x003f03f0));
+    auto const t3 = _mm_mullo_epi16(t2, _mm_set1_epi32(0x01000010));
+    return _mm_or_si128(t1, t3);
+}
+
+_DUALIS_TARGET("ssse3")
+[[nodiscard]] inline auto _base64_lookup_ssse3(__m128i indices) -> __m128i
+{
+    // Map each index onto the offset that has to be added to get its digit: 0..25 -> 'A',
+    // 26..51 -> 'a' - 26, 52..61 -> '0' - 52, 62 -> '+' - 62, 63 -> '/' - 63.
+    auto result = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    auto const less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    result = _mm_or_si128(result, _mm_and_si128(less, _mm_set1_epi8(13)));
+    auto const offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                       '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                       '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(offsets, result), indices);
+}
+
+_DUALIS_TARGET("ssse3")
+inline auto _encode_base64_ssse3(char* dest, const uint8_t* src, std::size_t length) -> std::size_t
+{
+    std::size_t offset = 0;
+    // Each step consumes 12 bytes, but loads 16.
+    for (; offset + 16 <= length; offset += 12, dest += 16)
+    {
+        auto const in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                         _base64_lookup_ssse3(_base64_split_ssse3(in)));
+    }
+    return offset + _encode_base64_scalar(dest, src + offset, length - offset);
+}
+
+_DUALIS_TARGET("avx2")
+inline auto _encode_base64_avx2(char* dest, const uint8_t* src, std::size_t length) -> std::size_t
+{
+    auto const split = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2,
+                                        1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    std::size_t offset = 0;
+    // Each step consumes 24 bytes, but loads 28 (12 + 16).
+    for (; offset + 28 <= length; offset += 24, dest += 32)
+    {
+        auto const low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset));
+        auto const high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + offset + 12));
+        auto in = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+        in = _mm256_shuffle_epi8(in, split);
+        auto const t0 = _mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00));
+        auto const t1 = _mm256_mulhi_epu16(t0, _mm256_set1_epi32(0x04000040));
+        auto const t2 = _mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0));
+        auto const t3 = _mm256_mullo_epi16(t2, _mm256_set1_epi32(0x01000010));
+        auto const indices = _mm256_or_si256(t1, t3);
+
+        auto result = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+        auto const less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+        result = _mm256_or_si256(result, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+        auto const offsets = _mm256_setr_epi8(
+            'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0, 'a' - 26, '0' - 52,
+            '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+            '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+        result = _mm256_add_epi8(_mm256_shuffle_epi8(offsets, result), indices);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), result);
+    }
+    return offset + _encode_base64_ssse3(dest, src + offset, length - offset);
+}
+#endif
+
+//== 24-bit integers ==============================================================================
+
+// Widens count packed 24-bit integers from src to 32 bits each, sign-extending them if Signed.
+template <std::endian Order, bool Signed>
+void _widen_24_scalar(uint32_t* dest, const std::byte* src, std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i, src += 3)
+    {
+        auto const b0 = std::to_integer<uint32_t>(src[0]);
+        auto const b1 = std::to_integer<uint32_t>(src[1]);
+        auto const b2 = std::to_integer<uint32_t>(src[2]);
+        // Place the value in the upper three bytes so that a single shift zero- or sign-extends it.
+        auto const value = Order == std::endian::little ? (b2 << 24) | (b1 << 16) | (b0 << 8)
+                                                        : (b0 << 24) | (b1 << 16) | (b2 << 8);
+        dest[i] = Signed ? static_cast<uint32_t>(static_cast<int32_t>(value) >> 8) : value >> 8;
+    }
+}
+
+#ifdef _DUALIS_X86
+// Moves the four 24-bit integers in the lowest 12 bytes of each 128-bit lane into the upper three
+// bytes of the four 32-bit lanes. Shifting right by 8 then zero- or sign-extends them.
+template <std::endian Order> constexpr auto _make_widen_24_shuffle() -> std::array<int8_t, 32>
+{
+    std::array<int8_t, 32> shuffle{};
+    for (std::size_t i = 0; i < shuffle.size(); ++i)
+    {
+        auto const value = i % 16 / 4;
+        auto const byte = i % 4;
+        shuffle[i] = byte == 0 ? -1
+                     : Order == std::endian::little
+                         ? static_cast<int8_t>(3 * value + byte - 1)
+                         : static_cast<int8_t>(3 * value + 3 - byte);
+    }
+    return shuffle;
+}
+
+template <std::endian Order>
+alignas(32) inline constexpr auto _widen_24_shuffle = _make_widen_24_shuffle<Order>();
+
+template <std::endian Order, bool Signed>
+_DUALIS_TARGET("ssse3")
+void _widen_24_ssse3(uint32_t* dest, const std::byte* src, std::size_t count)
+{
+    auto const shuffle =
+        _mm_load_si128(reinterpret_cast<const __m128i*>(_widen_24_shuffle<Order>.data()));
+    std::size_t i = 0;
+    // Each step consumes 12 bytes, but loads 16.
+    for (; 3 * i + 16 <= 3 * count; i += 4)
+    {
+        auto value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i));
+        value = _mm_shuffle_epi8(value, shuffle);
+        value = Signed ? _mm_srai_epi32(value, 8) : _mm_srli_epi32(value, 8);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), value);
+    }
+    _widen_24_scalar<Order, Signed>(dest + i, src + 3 * i, count - i);
+}
+
+template <std::endian Order, bool Signed>
+_DUALIS_TARGET("avx2")
+void _widen_24_avx2(uint32_t* dest, const std::byte* src, std::size_t count)
+{
+    auto const shuffle =
+        _mm256_load_si256(reinterpret_cast<const __m256i*>(_widen_24_shuffle<Order>.data()));
+    std::size_t i = 0;
+    // Each step consumes 24 bytes, but loads 28 (12 + 16).
+    for (; 3 * i + 28 <= 3 * count; i += 8)
+    {
+        auto const low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i));
+        auto const high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i + 12));
+        auto value = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+        value = _mm256_shuffle_epi8(value, shuffle);
+        value = Signed ? _mm256_srai_epi32(value, 8) : _mm256_srli_epi32(value, 8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), value);
+    }
+    _widen_24_ssse3<Order, Signed>(dest + i, src + 3 * i, count - i);
+}
+#endif
+
+//== byte search ===================================================================================
+
+// Returns the index of the first byte in [bytes, bytes + size) equal to value, or size if none is.
+inline auto _find_byte_scalar(const std::byte* bytes, std::size_t size, std::byte value)
+    -> std::size_t
+{
+    std::size_t offset = 0;
+    while (offset < size && bytes[offset] != value)
+    {
+        ++offset;
+    }
+    return offset;
+}
+
+#ifdef _DUALIS_X86
+_DUALIS_TARGET("sse2")
+inline auto _find_byte_sse2(const std::byte* bytes, std::size_t size, std::byte value)
+    -> std::size_t
+{
+    auto const needle = _mm_set1_epi8(static_cast<char>(value));
+    std::size_t offset = 0;
+    for (; offset + 16 <= size; offset += 16)
+    {
+        auto const chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + offset));
+        auto const mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+        if (mask != 0)
+        {
+            return offset + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return offset + _find_byte_scalar(bytes + offset, size - offset, value);
+}
+
+_DUALIS_TARGET("avx2")
+inline auto _find_byte_avx2(const std::byte* bytes, std::size_t size, std::byte value)
+    -> std::size_t
+{
+    auto const needle = _mm256_set1_epi8(static_cast<char>(value));
+    std::size_t offset = 0;
+    // Two vectors per iteration with a single branch keep up with the memory bandwidth.
+    for (; offset + 64 <= size; offset += 64)
+    {
+        auto const* in = reinterpret_cast<const __m256i*>(bytes + offset);
+        auto const equal0 = _mm256_cmpeq_epi8(_mm256_loadu_si256(in), needle);
+        auto const equal1 = _mm256_cmpeq_epi8(_mm256_loadu_si256(in + 1), needle);
+        if (!_mm256_testz_si256(_mm256_or_si256(equal0, equal1), _mm256_set1_epi8(-1)))
+        {
+            auto const mask = static_cast<uint32_t>(_mm256_movemask_epi8(equal0)) |
+                              uint64_t{static_cast<uint32_t>(_mm256_movemask_epi8(equal1))} << 32;
+            return offset + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return offset + _find_byte_sse2(bytes + offset, size - offset, value);
+}
+
+_DUALIS_TARGET("avx512f,avx512bw")
+inline auto _find_byte_avx512(const std::byte* bytes, std::size_t size, std::byte value)
+    -> std::size_t
+{
+    auto const needle = _mm512_set1_epi8(static_cast<char>(value));
+    std::size_t offset = 0;
+    for (; offset < size; offset += 64)
+    {
+        // The last chunk is loaded with a mask so that no byte beyond the end is read.
+        auto const remaining = size - offset;
+        auto const load_mask = remaining >= 64 ? ~__mmask64{0}
+                                               : static_cast<__mmask64>((1ULL << remaining) - 1);
+        auto const chunk = _mm512_maskz_loadu_epi8(load_mask, bytes + offset);
+        auto const mask = _mm512_mask_cmpeq_epi8_mask(load_mask, chunk, needle);
+        if (mask != 0)
+        {
+            return offset + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return size;
+}
+#endif
+
+//== strided gathering =============================================================================
+
+// Copies count elements of Width bytes each from src, where consecutive elements are stride bytes
+// apart, to consecutive elements in dest (e.g. one field of an array of records).
+template <std::size_t Width>
+void _gather_strided_scalar(std::byte* dest, const std::byte* src, std::size_t stride,
+                            std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i, dest += Width, src += stride)
+    {
+        copy_bytes(dest, src, Width);
+    }
+}
+
+#ifdef _DUALIS_X86
+template <std::size_t Width>
+_DUALIS_TARGET("avx2")
+void _gather_strided_avx2(std::byte* dest, const std::byte* src, std::size_t stride,
+                          std::size_t count)
+{
+    static_assert(Width == 4 || Width == 8);
+    constexpr std::size_t lanes = 32 / Width;
+    // The byte offsets of the lanes must fit into 32-bit indices.
+    if (stride > static_cast<std::size_t>(std::numeric_limits<int32_t>::max()) / lanes)
+    {
+        _gather_strided_scalar<Width>(dest, src, stride, count);
+        return;
+    }
+    auto const step = static_cast<int32_t>(stride);
+    std::size_t i = 0;
+    if constexpr (Width == 4)
+    {
+        auto const indices = _mm256_mullo_epi32(_mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7),
+                                                _mm256_set1_epi32(step));
+        for (; i + lanes <= count; i += lanes)
+        {
+            auto const* base = reinterpret_cast<const int*>(src + i * stride);
+            auto const values = _mm256_i32gather_epi32(base, indices, 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i * Width), values);
+        }
+    }
+    else
+    {
+        auto const indices =
+            _mm_mullo_epi32(_mm_setr_epi32(0, 1, 2, 3), _mm_set1_epi32(step));
+        for (; i + lanes <= count; i += lanes)
+        {
+            auto const* base = reinterpret_cast<const long long*>(src + i * stride);
+            auto const values = _mm256_i32gather_epi64(base, indices, 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i * Width), values);
+        }
+    }
+    _gather_strided_scalar<Width>(dest + i * Width, src + i * stride, stride, count - i);
+}
+#endif
+
+//== dispatch =====================================================================================
+
+// Table of the kernels selected for one simd_level.
+struct _simd_kernels
+{
+    simd_level level{simd_level::scalar};
+    void (*copy_swapped_2)(std::byte*, const std::byte*, std::size_t){_copy_swapped_scalar<2>};
+    void (*copy_swapped_4)(std::byte*, const std::byte*, std::size_t){_copy_swapped_scalar<4>};
+    void (*copy_swapped_8)(std::byte*, const std::byte*, std::size_t){_copy_swapped_scalar<8>};
+    std::size_t (*encode_base64)(char*, const uint8_t*, std::size_t){_encode_base64_scalar};
+    std::size_t (*find_byte)(const std::byte*, std::size_t, std::byte){_find_byte_scalar};
+    using gather_strided_kernel = void (*)(std::byte*, const std::byte*, std::size_t, std::size_t);
+    gather_strided_kernel gather_strided_4{_gather_strided_scalar<4>};
+    gather_strided_kernel gather_strided_8{_gather_strided_scalar<8>};
+    // Indexed by [big endian][signed].
+    using widen_24_kernel = void (*)(uint32_t*, const std::byte*, std::size_t);
+    std::array<std::array<widen_24_kernel, 2>, 2> widen_24_kernels{
+        {{_widen_24_scalar<std::endian::little, false>,
+          _widen_24_scalar<std::endian::little, true>},
+         {_widen_24_scalar<std::endian::big, false>, _widen_24_scalar<std::endian::big, true>}}};
+
+    template <std::size_t Width> [[nodiscard]] auto copy_swapped() const
+    {
+        if constexpr (Width == 2)
+        {
+            return copy_swapped_2;
+        }
+        else if constexpr (Width == 4)
+        {
+            return copy_swapped_4;
+        }
+        else
+        {
+            return copy_swapped_8;
+        }
+    }
+
+    template <std::endian Order, bool Signed> [[nodiscard]] auto widen_24() const
+    {
+        return widen_24_kernels[Order == std::endian::big][Signed];
+    }
+};
+
+// Builds the table of the best kernels available for the given level. Exposed (rather than only
+// the active table) so that every variant can be tested on capable machines.
+[[nodiscard]] inline auto _make_simd_kernels(simd_level level) -> _simd_kernels
+{
+    _simd_kernels kernels;
+    kernels.level = level;
+#ifdef _DUALIS_X86
+    switch (level)
+    {
+    case simd_level::avx512:
+        kernels.copy_swapped_2 = _copy_swapped_avx512<2>;
+        kernels.copy_swapped_4 = _copy_swapped_avx512<4>;
+        kernels.copy_swapped_8 = _copy_swapped_avx512<8>;
+        kernels.find_byte = _find_byte_avx512;
+        kernels.gather_strided_4 = _gather_strided_avx2<4>;
+        kernels.gather_strided_8 = _gather_strided_avx2<8>;
+        // AVX-512 without VBMI offers little over AVX2 for base64 and 24-bit integers.
+        kernels.encode_base64 = _encode_base64_avx2;
+        kernels.widen_24_kernels = {{{_widen_24_avx2<std::endian::little, false>,
+                                      _widen_24_avx2<std::endian::little, true>},
+                                     {_widen_24_avx2<std::endian::big, false>,
+                                      _widen_24_avx2<std::endian::big, true>}}};
+        break;
+    case simd_level::avx2:
+        kernels.copy_swapped_2 = _copy_swapped_avx2<2>;
+        kernels.copy_swapped_4 = _copy_swapped_avx2<4>;
+        kernels.copy_swapped_8 = _copy_swapped_avx2<8>;
+        kernels.find_byte = _find_byte_avx2;
+        kernels.gather_strided_4 = _gather_strided_avx2<4>;
+        kernels.gather_strided_8 = _gather_strided_avx2<8>;
+        kernels.encode_base64 = _encode_base64_avx2;
+        kernels.widen_24_kernels = {{{_widen_24_avx2<std::endian::little, false>,
+                                      _widen_24_avx2<std::endian::little, true>},
+                                     {_widen_24_avx2<std::endian::big, false>,
+                                      _widen_24_avx2<std::endian::big, true>}}};
+        break;
+    case simd_level::ssse3:
+        kernels.copy_swapped_2 = _copy_swapped_ssse3<2>;
+        kernels.copy_swapped_4 = _copy_swapped_ssse3<4>;
+        kernels.copy_swapped_8 = _copy_swapped_ssse3<8>;
+        kernels.find_byte = _find_byte_sse2;
+        kernels.encode_base64 = _encode_base64_ssse3;
+        kernels.widen_24_kernels = {{{_widen_24_ssse3<std::endian::little, false>,
+                                      _widen_24_ssse3<std::endian::little, true>},
+                                     {_widen_24_ssse3<std::endian::big, false>,
+                                      _widen_24_ssse3<std::endian::big, true>}}};
+        break;
+    case simd_level::sse2:
+        kernels.copy_swapped_2 = _copy_swapped_sse2<2>;
+        kernels.copy_swapped_4 = _copy_swapped_sse2<4>;
+        kernels.copy_swapped_8 = _copy_swapped_sse2<8>;
+        kernels.find_byte = _find_byte_sse2;
+        break;
+    default: break;
+    }
+#else
+    kernels.level = simd_level::scalar;
+#endif
+    return kernels;
+}
+
+// The kernels are selected once, on first use, based on the CPU the program runs on.
+[[nodiscard]] inline auto _active_simd_kernels() -> const _simd_kernels&
+{
+    static const _simd_kernels kernels = _make_simd_kernels(detect_simd_level());
+    return kernels;
+}
+
+} // namespace detail
+
+// Returns the simd_level of the kernels used by the bulk operations in this process, e.g. for
+// logging it at startup.
+[[nodiscard]] inline auto active_simd_level() -> simd_level
+{
+    return detail::_active_simd_kernels().level;
+}
+
+// Copies count elements of Width bytes each from src to dest and reverses the byte order of each
+// element in the process. src and dest may be identical, but must not overlap otherwise.
+template <std::size_t Width>
+void copy_swapped_bytes(std::byte* dest, const std::byte* src, std::size_t count)
+{
+    static_assert(Width == 1 || Width == 2 || Width == 4 || Width == 8);
+    if constexpr (Width == 1)
+    {
+        if (dest != src)
+        {
+            copy_bytes(dest, src, count);
+        }
+    }
+    else
+    {
+        // Not worth the indirect call if not even a single vector's worth of elements.
+        if (count * Width < 16)
+        {
+            detail::_copy_swapped_scalar<Width>(dest, src, count);
+        }
+        else
+        {
+            detail::_active_simd_kernels().copy_swapped<Width>()(dest, src, count);
+        }
+    }
+}
+
+// Widens count packed 24-bit integers with the given byte order from src to 32 bits each in dest,
+// sign-extending them if Signed.
+template <std::endian Order, bool Signed>
+void widen_24_bit(uint32_t* dest, const std::byte* src, std::size_t count)
+{
+    // Not worth the indirect call if not even a single vector's worth of elements.
+    if (count < 8)
+    {
+        detail::_widen_24_scalar<Order, Signed>(dest, src, count);
+    }
+    else
+    {
+        detail::_active_simd_kernels().widen_24<Order, Signed>()(dest, src, count);
+    }
+}
+
+// Returns the index of the first byte in [bytes, bytes + size) equal to value, or size if none is.
+[[nodiscard]] inline auto find_byte(const std::byte* bytes, std::size_t size, std::byte value)
+    -> std::size_t
+{
+    return detail::_active_simd_kernels().find_byte(bytes, size, value);
+}
+
+// Copies count elements of Width bytes each from src, where consecutive elements are stride bytes
+// apart, to consecutive elements in dest. dest and src must not overlap.
+template <std::size_t Width>
+void gather_strided_bytes(std::byte* dest, const std::byte* src, std::size_t stride,
+                          std::size_t count)
+{
+    if constexpr (Width == 4 || Width == 8)
+    {
+        if (count >= 32 / Width)
+        {
+            if constexpr (Width == 4)
+            {
+                detail::_active_simd_kernels().gather_strided_4(dest, src, stride, count);
+            }
+            else
+            {
+                detail::_active_simd_kernels().gather_strided_8(dest, src, stride, count);
+            }
+            return;
+        }
+    }
+    detail::_gather_strided_scalar<Width>(dest, src, stride, count);
+}
+
+} // namespace dualis
@@ -1,6 +1,9 @@
 #pragma once
 
 #include "containers.h"
+#include "variant.h"
+#include "varint.h"
+#include "views.h"
 
 namespace dualis {
 
@@ -36,14 +39,42 @@ public:
         return value;
     }
 
-    template <byte_packing... Packings>
-    [[nodiscard]] auto unpack_tuple() -> std::tuple<typename Packings::value_type...>
+    // Alignment pseudo packings among Packings are relative to the start of the tuple.
+    template <detail::_tuple_element... Packings>
+    [[nodiscard]] auto unpack_tuple() -> typename tuple_packing<Packings...>::value_type
     {
         auto const value = ::dualis::unpack_tuple<Packings...>(m_data, m_offset);
         m_offset += tuple_packing<Packings...>::size();
         return value;
     }
 
+    // Skips the bytes of a pseudo packing, e.g. align<4> skips to the next multiple of 4 bytes from
+    // the start of the span.
+    template <pseudo_packing Packing> void advance()
+    {
+        m_offset += Packing::size(m_offset);
+    }
+
+    // Skips the bytes of Packing (e.g. expect_bytes<"RIFF"> or a tuple_packing containing it) if
+    // they match its constant bytes, and returns whether they did.
+    template <detail::_matching Packing> [[nodiscard]] auto advance_if_matches() -> bool
+    {
+        if (!::dualis::matches<Packing>(m_data, m_offset))
+        {
+            return false;
+        }
+        m_offset += detail::_size_at<Packing>(0);
+        return true;
+    }
+
+    template <byte_packing... Packings, class... Outputs>
+    requires(sizeof...(Packings) == sizeof...(Outputs))
+    void unpack_into(Outputs&... outputs)
+    {
+        ::dualis::unpack_into<Packings...>(m_data, m_offset, outputs...);
+        m_offset += (Packings::size() + ...);
+    }
+
     template <byte_packing Packing, class OutputIt>
     auto unpack_range(OutputIt first, std::size_t n) -> OutputIt
     {
@@ -52,11 +83,362 @@ public:
         return after;
     }
 
+    // Returns a view of the next n values, which are unpacked only when accessed, and skips them.
+    template <byte_packing Packing>
+    [[nodiscard]] auto unpack_view(std::size_t n) -> packed_view<Packing>
+    {
+        packed_view<Packing> const view{m_data, m_offset, n};
+        m_offset += Packing::size() * n;
+        return view;
+    }
+
+    template <variable_byte_packing Packing>
+    [[nodiscard]] auto unpack() -> typename Packing::value_type
+    {
+        std::size_t size;
+        auto const value = Packing::unpack(m_data.data() + m_offset, size);
+        m_offset += size;
+        return value;
+    }
+
+    template <variable_byte_packing Packing, class OutputIt>
+    auto unpack_range(OutputIt first, std::size_t n) -> OutputIt
+    {
+        auto const [offset, after] =
+            ::dualis::unpack_varint_range<Packing>(m_data, m_offset, first, n);
+        m_offset = offset;
+        return after;
+    }
+
+    // Unpacks the next tagged union of the given variant_packing and calls visitor with its payload
+    // (see variant_packing::visit), without constructing an std::variant. The stream is advanced
+    // past the payload before the visitor is called, so the visitor may continue reading.
+    template <class VariantPacking, class Visitor> decltype(auto) visit_next(Visitor&& visitor)
+    {
+        std::size_t size = 0;
+        return VariantPacking::visit(
+            m_data.data() + m_offset, size,
+            [&](auto&& payload, auto index) -> decltype(auto) {
+                m_offset += size;
+                using payload_type = decltype(payload);
+                if constexpr (std::invocable<Visitor&, payload_type, decltype(index)>)
+                {
+                    return std::invoke(visitor, std::forward<payload_type>(payload), index);
+                }
+                else
+                {
+                    return std::invoke(visitor, std::forward<payload_type>(payload));
+                }
+            });
+    }
+
+    // Reads the string up to the next terminator (or the end of the bytes) and skips the
+    // terminator. The returned view refers to the streamed bytes.
+    [[nodiscard]] auto read_cstring(std::byte terminator = std::byte{0}) -> std::string_view
+    {
+        auto const value = ::dualis::unpack_cstring(m_data, m_offset, terminator);
+        auto const end = m_offset + value.size();
+        m_offset = end < m_data.size() ? end + 1 : end;
+        return value;
+    }
+
 private:
     byte_span m_data;
     std::size_t m_offset{0};
 };
 
+// The order in which the bits of a byte are read (or written).
+enum class bit_order
+{
+    // The first bit of a byte is its most significant bit (e.g. JPEG, MIDI).
+    msb_first,
+    // The first bit of a byte is its least significant bit (e.g. DEFLATE).
+    lsb_first,
+};
+
+// Reads values of arbitrary bit widths from a byte_span. The bits are buffered in a 64-bit register
+// that is refilled by a single unaligned load without branching, except close to the end of the
+// data. Reading past the end yields zero bits.
+template <bit_order Order = bit_order::msb_first> class bit_stream
+{
+public:
+    // The maximum number of bits that can be peeked or read at once.
+    static constexpr unsigned max_bits = 56;
+
+    bit_stream() = default;
+
+    explicit bit_stream(byte_span bytes, std::size_t offset = 0) noexcept
+        : m_data{bytes}
+        , m_offset{offset}
+    {
+    }
+
+    // Continues reading bits where the given byte_stream currently is.
+    explicit bit_stream(const byte_stream& stream) noexcept
+        : bit_stream{stream.span(), stream.tellg()}
+    {
+    }
+
+    // Returns the position of the next unread bit, counted in bits from the start of the span.
+    [[nodiscard]] auto tell_bits() const noexcept -> std::size_t
+    {
+        return m_offset * 8 - m_count;
+    }
+
+    // Returns the offset of the next unread byte, that is, where reading continues after a call to
+    // align_to_byte(). Pass it to byte_stream::seekg() to continue reading whole bytes.
+    [[nodiscard]] auto tellg() const noexcept -> std::size_t
+    {
+        return (tell_bits() + 7) / 8;
+    }
+
+    void seek_bits(std::size_t position) noexcept
+    {
+        m_offset = position / 8;
+        m_buffer = 0;
+        m_count = 0;
+        if (position % 8 != 0)
+        {
+            _refill();
+            _consume(position % 8);
+        }
+    }
+
+    [[nodiscard]] auto span() const noexcept -> const byte_span&
+    {
+        return m_data;
+    }
+
+    // Returns the next count bits (at most max_bits) without consuming them. In msb_first order,
+    // the first bit is the most significant bit of the result; in lsb_first order, it is the least
+    // significant one (like the fields of a DEFLATE stream).
+    [[nodiscard]] auto peek_bits(unsigned count) noexcept -> uint64_t
+    {
+        _refill();
+        if constexpr (Order == bit_order::msb_first)
+        {
+            // Shifting twice avoids an undefined shift by 64 for count == 0.
+            return (m_buffer >> 1) >> (63 - count);
+        }
+        else
+        {
+            return m_buffer & ((uint64_t{1} << count) - 1);
+        }
+    }
+
+    [[nodiscard]] auto read_bits(unsigned count) noexcept -> uint64_t
+    {
+        auto const value = peek_bits(count);
+        _consume(count);
+        return value;
+    }
+
+    [[nodiscard]] auto read_bit() noexcept -> bool
+    {
+        return read_bits(1) != 0;
+    }
+
+    void skip_bits(std::size_t count) noexcept
+    {
+        if (count <= max_bits)
+        {
+            _refill();
+            _consume(static_cast<unsigned>(count));
+        }
+        else
+        {
+            seek_bits(tell_bits() + count);
+        }
+    }
+
+    // Skips the remaining bits of the current byte (if any).
+    void align_to_byte() noexcept
+    {
+        _consume(m_count % 8);
+    }
+
+private:
+    // Makes sure that at least max_bits bits are buffered. Bits beyond m_count are reloaded from
+    // the same bytes, so or-ing them in again does not change them (see Fabian Giesen, "Reading
+    // bits in far too many ways", variant 4).
+    void _refill() noexcept
+    {
+        uint64_t word;
+        if (m_offset + 8 <= m_data.size())
+        {
+            word = _load(m_data.data() + m_offset);
+        }
+        else
+        {
+            std::byte tail[8]{};
+            if (m_offset < m_data.size())
+            {
+                copy_bytes(tail, m_data.data() + m_offset, m_data.size() - m_offset);
+            }
+            word = _load(tail);
+        }
+        if constexpr (Order == bit_order::msb_first)
+        {
+            m_buffer |= word >> m_count;
+        }
+        else
+        {
+            m_buffer |= word << m_count;
+        }
+        m_offset += (63 - m_count) >> 3;
+        m_count |= 56;
+    }
+
+    void _consume(unsigned count) noexcept
+    {
+        if constexpr (Order == bit_order::msb_first)
+        {
+            m_buffer <<= count;
+        }
+        else
+        {
+            m_buffer >>= count;
+        }
+        m_count -= count;
+    }
+
+    [[nodiscard]] static auto _load(const std::byte* bytes) noexcept -> uint64_t
+    {
+        if constexpr (Order == bit_order::msb_first)
+        {
+            return uint64_be::unpack(bytes);
+        }
+        else
+        {
+            return uint64_le::unpack(bytes);
+        }
+    }
+
+    byte_span m_data;
+    std::size_t m_offset{0};
+    uint64_t m_buffer{0};
+    unsigned m_count{0};
+};
+
+// Writes values of arbitrary bit widths to the end of a byte_container. The bits are accumulated in
+// a 64-bit register, which is appended to the container as a whole once it is full. Call flush()
+// to write out the remaining bits.
+template <bit_order Order = bit_order::msb_first, class Bytes = byte_vector> class bit_writer
+{
+public:
+    // Reserves space for expected_bits more bits in the given container, so that in the common
+    // case, writing out the register is a single unaligned store.
+    explicit bit_writer(Bytes& bytes, std::size_t expected_bits = 0)
+        : m_bytes{bytes}
+    {
+        m_bytes.reserve(m_bytes.size() + expected_bits / 8 + sizeof(uint64_t));
+    }
+
+    bit_writer(const bit_writer&) = delete;
+    auto operator=(const bit_writer&) -> bit_writer& = delete;
+
+    // Returns the number of bits written so far, including the bytes of the container that already
+    // existed before.
+    [[nodiscard]] auto tell_bits() const noexcept -> std::size_t
+    {
+        return m_bytes.size() * 8 + m_count;
+    }
+
+    // Writes the lowest count bits (at most 64) of value. In msb_first order, the most significant
+    // of these bits is written first; in lsb_first order, the least significant one.
+    void write_bits(uint64_t value, unsigned count)
+    {
+        // Writing nothing would shift by 64 below if the register is empty.
+        if (count == 0)
+        {
+            return;
+        }
+        if (count < 64)
+        {
+            value &= (uint64_t{1} << count) - 1;
+        }
+        auto const free = 64 - m_count;
+        if (count < free)
+        {
+            if constexpr (Order == bit_order::msb_first)
+            {
+                m_buffer |= value << (free - count);
+            }
+            else
+            {
+                m_buffer |= value << m_count;
+            }
+            m_count += count;
+        }
+        else
+        {
+            // Fill up the register, write it out and keep the bits that did not fit.
+            auto const remaining = count - free;
+            if constexpr (Order == bit_order::msb_first)
+            {
+                m_buffer |= value >> remaining;
+                m_bytes.template append_packed<uint64_be>(m_buffer);
+                m_buffer = remaining > 0 ? value << (64 - remaining) : 0;
+            }
+            else
+            {
+                m_buffer |= value << m_count;
+                m_bytes.template append_packed<uint64_le>(m_buffer);
+                m_buffer = remaining > 0 ? value >> free : 0;
+            }
+            m_count = remaining;
+        }
+    }
+
+    void write_bit(bool value)
+    {
+        write_bits(value ? 1 : 0, 1);
+    }
+
+    // Pads the current byte (if any) with zero bits.
+    void align_to_byte()
+    {
+        m_count = (m_count + 7) & ~7u;
+        // A full register must be written out, since write_bits expects room for at least one bit.
+        if (m_count == 64)
+        {
+            if constexpr (Order == bit_order::msb_first)
+            {
+                m_bytes.template append_packed<uint64_be>(m_buffer);
+            }
+            else
+            {
+                m_bytes.template append_packed<uint64_le>(m_buffer);
+            }
+            m_buffer = 0;
+            m_count = 0;
+        }
+    }
+
+    // Aligns to the next byte and appends all bytes still held in the register to the container.
+    void flush()
+    {
+        align_to_byte();
+        std::byte bytes[sizeof(uint64_t)];
+        if constexpr (Order == bit_order::msb_first)
+        {
+            uint64_be::pack(bytes, m_buffer);
+        }
+        else
+        {
+            uint64_le::pack(bytes, m_buffer);
+        }
+        m_bytes.append(bytes, m_count / 8);
+        m_buffer = 0;
+        m_count = 0;
+    }
+
+private:
+    Bytes& m_bytes;
+    uint64_t m_buffer{0};
+    unsigned m_count{0};
+};
+
 namespace detail {
 
 template <byte_packing Packing> class _stream_unpacker
@@ -57,6 +57,20 @@ template <> struct _signed_int<8>
 template <std::size_t Width> using unsigned_int = typename detail::_unsigned_int<Width>::type;
 template <std::size_t Width> using signed_int = typename detail::_signed_int<Width>::type;
 
+namespace detail {
+
+[[nodiscard]] constexpr auto _least_int_width(std::size_t width) -> std::size_t
+{
+    return width <= 1 ? 1 : width <= 2 ? 2 : width <= 4 ? 4 : 8;
+}
+
+} // namespace detail
+
+// The smallest integers that hold at least Width bytes (e.g. uint32_t for 3 bytes).
+template <std::size_t Width>
+using least_unsigned_int = unsigned_int<detail::_least_int_width(Width)>;
+template <std::size_t Width> using least_signed_int = signed_int<detail::_least_int_width(Width)>;
+
 // Swaps the byte order of the given integer.
 template <std::unsigned_integral T> [[nodiscard]] auto byte_swap(T value) -> T;
 
@@ -190,53 +204,8 @@ inline auto to_binary_string(long long value) -> std::string
     return std::string(result.crbegin(), result.crend());
 }
 
-template <byte_range Bytes> auto to_base64(const Bytes& bytes) -> std::string
-{
-    static constexpr char Digits[65] =
-        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-
-    auto const length = std::ranges::size(bytes);
-    auto const* data = reinterpret_cast<const uint8_t*>(std::ranges::cdata(bytes));
-    size_t offset = 0;
-    std::string base64;
-    for (; offset + 3 <= length; offset += 3)
-    {
-        uint8_t separated;
-        separated = data[offset] >> 2;
-        base64 += Digits[separated];
-        separated = ((data[offset] & 0x03) << 4) | (data[offset + 1] >> 4);
-        base64 += Digits[separated];
-        separated = ((data[offset + 1] & 0x0f) << 2) | (data[offset + 2] >> 6);
-        base64 += Digits[separated];
-        separated = data[offset + 2] & 0x3f;
-        base64 += Digits[separated];
-    }
-    if (offset < length)
-    {
-        if (length - offset == 2)
-        {
-            uint8_t separated;
-            separated = data[offset] >> 2;
-            base64 += Digits[separated];
-            separated = ((data[offset] & 0x03) << 4) | (data[offset + 1] >> 4);
-            base64 += Digits[separated];
-            separated = (data[offset + 1] & 0x0f) << 2;
-            base64 += Digits[separated];
-            base64 += '=';
-        }
-        if (length - offset == 1)
-        {
-            uint8_t separated;
-            separated = data[offset] >> 2;
-            base64 += Digits[separated];
-            separated = (data[offset] & 0x03) << 4;
-            base64 += Digits[separated];
-            base64 += '=';
-            base64 += '=';
-        }
-    }
-    return base64;
-}
+// Encodes the given bytes as base64 (with padding). Uses vectorized kernels if available.
+template <byte_range Bytes> auto to_base64(const Bytes& bytes) -> std::string;
 
 namespace detail {
 
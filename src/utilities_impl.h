@@ -59,3 +59,31 @@ void hex_dump(byte_span data, LineConsumer&& consume, size_t columns = 16, size_
         consume(line);
     }
 }
+
+template <byte_range Bytes> auto to_base64(const Bytes& bytes) -> std::string
+{
+    auto const length = std::ranges::size(bytes);
+    auto const* data = reinterpret_cast<const uint8_t*>(std::ranges::cdata(bytes));
+    std::string base64((length + 2) / 3 * 4, '=');
+    auto const offset = detail::_active_simd_kernels().encode_base64(base64.data(), data, length);
+    auto* const digits = base64.data() + offset / 3 * 4;
+    if (length - offset == 2)
+    {
+        uint8_t separated;
+        separated = data[offset] >> 2;
+        digits[0] = detail::_base64_digits[separated];
+        separated = ((data[offset] & 0x03) << 4) | (data[offset + 1] >> 4);
+        digits[1] = detail::_base64_digits[separated];
+        separated = (data[offset + 1] & 0x0f) << 2;
+        digits[2] = detail::_base64_digits[separated];
+    }
+    if (length - offset == 1)
+    {
+        uint8_t separated;
+        separated = data[offset] >> 2;
+        digits[0] = detail::_base64_digits[separated];
+        separated = (data[offset] & 0x03) << 4;
+        digits[1] = detail::_base64_digits[separated];
+    }
+    return base64;
+}
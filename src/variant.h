@@ -0,0 +1,267 @@
+#pragma once
+
+#include "concepts.h"
+#include "packing.h"
+#include "varint.h"
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace dualis {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Tagged unions
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Describes an alternative of a variant_packing: the payload following the given tag is packed with
+// Packing, which may be a byte_packing or a variable_byte_packing.
+template <auto Tag, class Packing>
+requires byte_packing<Packing> || variable_byte_packing<Packing>
+struct alternative
+{
+    static constexpr auto tag = Tag;
+    using packing = Packing;
+};
+
+namespace detail {
+
+// Unpacks, measures or packs a value with either a fixed-size or a variable-size packing.
+template <class Packing>
+[[nodiscard]] auto _unpack_sized(const std::byte* bytes, std::size_t& size) ->
+    typename Packing::value_type
+{
+    if constexpr (byte_packing<Packing>)
+    {
+        size = Packing::size();
+        return Packing::unpack(bytes);
+    }
+    else
+    {
+        return Packing::unpack(bytes, size);
+    }
+}
+
+template <class Packing>
+[[nodiscard]] auto _packed_size(const typename Packing::value_type& value) -> std::size_t
+{
+    if constexpr (byte_packing<Packing>)
+    {
+        return Packing::size();
+    }
+    else
+    {
+        return Packing::size(value);
+    }
+}
+
+template <class Packing>
+auto _pack_sized(std::byte* bytes, const typename Packing::value_type& value) -> std::size_t
+{
+    if constexpr (byte_packing<Packing>)
+    {
+        Packing::pack(bytes, value);
+        return Packing::size();
+    }
+    else
+    {
+        return Packing::pack(bytes, value);
+    }
+}
+
+// Calls visitor(payload, index) if the visitor takes the index of the alternative, or else
+// visitor(payload).
+template <class Visitor, class Payload, class Index>
+decltype(auto) _visit_payload(Visitor& visitor, Payload&& payload, Index index)
+{
+    if constexpr (std::invocable<Visitor&, Payload, Index>)
+    {
+        return std::invoke(visitor, std::forward<Payload>(payload), index);
+    }
+    else
+    {
+        return std::invoke(visitor, std::forward<Payload>(payload));
+    }
+}
+
+// Calls f(std::integral_constant<std::size_t, index>{}) through a table of function pointers, one
+// for each index below Count, instead of comparing index with each of them.
+template <std::size_t Count, class F> decltype(auto) _jump(std::size_t index, F& f)
+{
+    using result_type = decltype(f(std::integral_constant<std::size_t, 0>{}));
+    constexpr auto table = []<std::size_t... Indices>(std::index_sequence<Indices...>) {
+        return std::array<result_type (*)(F&), Count>{[](F& f) -> result_type {
+            return f(std::integral_constant<std::size_t, Indices>{});
+        }...};
+    }(std::make_index_sequence<Count>{});
+    return table[index](f);
+}
+
+// Maps the tags of a variant_packing to the indices of their alternatives (see _integer_set).
+// Unknown tags map to the number of tags.
+template <class T, auto... Tags> struct _tag_index
+{
+    using integer_type = typename std::conditional_t<std::is_enum_v<T>, std::underlying_type<T>,
+                                                     std::type_identity<T>>::type;
+    using set_type =
+        _integer_set<integer_type, static_cast<integer_type>(static_cast<T>(Tags))...>;
+
+    static_assert(sizeof...(Tags) > 0 && sizeof...(Tags) <= std::numeric_limits<uint8_t>::max());
+    // Otherwise, unpacking would yield only the last alternative with a tag that all of them pack.
+    static_assert(set_type::distinct, "the tags of a variant_packing must be distinct");
+
+    [[nodiscard]] static constexpr auto find(T tag) -> std::size_t
+    {
+        return set_type::find(static_cast<integer_type>(tag));
+    }
+};
+
+} // namespace detail
+
+// Packs one of several alternatives as a tag (packed with TagPacking) followed by the payload of
+// the alternative with that tag. Unpacking yields an std::variant with one alternative per given
+// alternative, in the same order. The alternative of a tag is looked up in a table generated at
+// compile time and dispatched through a table of function pointers. Unpacking an unknown tag throws
+// std::invalid_argument; try_unpack and try_visit report it as unpack_error::invalid_value instead.
+//
+// To dispatch on the payload without constructing the variant, use visit (or
+// byte_stream::visit_next).
+template <byte_packing TagPacking, class... Alternatives> struct variant_packing
+{
+    using tag_type = typename TagPacking::value_type;
+    using value_type = std::variant<typename Alternatives::packing::value_type...>;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes, std::size_t& size) -> value_type
+    {
+        return visit(bytes, size, [](auto&& payload, auto index) {
+            return value_type{std::in_place_index<decltype(index)::value>, std::move(payload)};
+        });
+    }
+
+    [[nodiscard]] static auto size(const value_type& value) -> std::size_t
+    {
+        auto const payload_size = [&](auto index) {
+            constexpr auto i = decltype(index)::value;
+            return detail::_packed_size<packing<i>>(std::get<i>(value));
+        };
+        return TagPacking::size() + detail::_jump<count>(value.index(), payload_size);
+    }
+
+    static auto pack(std::byte* bytes, const value_type& value) -> std::size_t
+    {
+        auto const pack_payload = [&](auto index) {
+            constexpr auto i = decltype(index)::value;
+            TagPacking::pack(bytes, tag<i>);
+            return detail::_pack_sized<packing<i>>(bytes + TagPacking::size(), std::get<i>(value));
+        };
+        return TagPacking::size() + detail::_jump<count>(value.index(), pack_payload);
+    }
+
+    // Unpacks the payload at bytes and calls visitor(payload), or visitor(payload, index) if the
+    // visitor takes the index of the alternative as an std::integral_constant (e.g. to tell apart
+    // alternatives of the same type). Sets size to the number of bytes of the tag and the payload
+    // before calling the visitor. All calls must return the same type.
+    template <class Visitor>
+    static decltype(auto) visit(const std::byte* bytes, std::size_t& size, Visitor&& visitor)
+    {
+        auto const index = tags::find(TagPacking::unpack(bytes));
+        if (index == count) [[unlikely]]
+        {
+            throw std::invalid_argument{"unknown variant tag"};
+        }
+        auto const visit_payload = [&](auto index) -> decltype(auto) {
+            std::size_t payload_size;
+            auto payload = detail::_unpack_sized<packing<decltype(index)::value>>(
+                bytes + TagPacking::size(), payload_size);
+            size = TagPacking::size() + payload_size;
+            return detail::_visit_payload(visitor, std::move(payload), index);
+        };
+        return detail::_jump<count>(index, visit_payload);
+    }
+
+    // Like unpack, but reads at most available bytes and returns an unpack_error instead of
+    // throwing or reading past them (see try_visit).
+    [[nodiscard]] static auto try_unpack(const std::byte* bytes, std::size_t available,
+                                         std::size_t& size)
+        -> std::expected<value_type, unpack_error>
+    {
+        return try_visit(bytes, available, size, [](auto&& payload, auto index) {
+            return value_type{std::in_place_index<decltype(index)::value>, std::move(payload)};
+        });
+    }
+
+    // Like visit, but reads at most available bytes. Returns unpack_error::invalid_value for an
+    // unknown tag and unpack_error::out_of_bounds if the tag or the payload does not end within
+    // them, without calling the visitor. Otherwise, returns the result of the visitor, which must
+    // not be a reference. Variable-size payloads must be checked_variable_byte_packings.
+    template <class Visitor>
+    static auto try_visit(const std::byte* bytes, std::size_t available, std::size_t& size,
+                          Visitor&& visitor)
+    {
+        using visitor_result = decltype(detail::_visit_payload(
+            visitor, std::declval<typename packing<0>::value_type>(),
+            std::integral_constant<std::size_t, 0>{}));
+        using result_type = std::expected<visitor_result, unpack_error>;
+
+        auto const tag = ::dualis::try_unpack<TagPacking>(byte_span{bytes, available}, 0);
+        if (!tag) [[unlikely]]
+        {
+            return result_type{std::unexpect, tag.error()};
+        }
+        auto const index = tags::find(*tag);
+        if (index == count) [[unlikely]]
+        {
+            return result_type{std::unexpect, unpack_error::invalid_value};
+        }
+        auto const visit_payload = [&](auto index) -> result_type {
+            std::size_t payload_size;
+            auto payload = detail::_try_unpack_sized<packing<decltype(index)::value>>(
+                bytes + TagPacking::size(), available - TagPacking::size(), payload_size);
+            if (!payload) [[unlikely]]
+            {
+                return result_type{std::unexpect, payload.error()};
+            }
+            size = TagPacking::size() + payload_size;
+            if constexpr (std::is_void_v<visitor_result>)
+            {
+                detail::_visit_payload(visitor, std::move(*payload), index);
+                return {};
+            }
+            else
+            {
+                return detail::_visit_payload(visitor, std::move(*payload), index);
+            }
+        };
+        return detail::_jump<count>(index, visit_payload);
+    }
+
+    // The index of the alternative with the given tag, or npos if there is none.
+    [[nodiscard]] static constexpr auto find(tag_type tag) -> std::size_t
+    {
+        auto const index = tags::find(tag);
+        return index == count ? npos : index;
+    }
+
+    static constexpr auto npos = static_cast<std::size_t>(-1);
+
+private:
+    static constexpr std::size_t count = sizeof...(Alternatives);
+    using tags = detail::_tag_index<tag_type, Alternatives::tag...>;
+
+    template <std::size_t Index>
+    using packing = typename std::tuple_element_t<Index, std::tuple<Alternatives...>>::packing;
+
+    template <std::size_t Index>
+    static constexpr auto tag =
+        static_cast<tag_type>(std::tuple_element_t<Index, std::tuple<Alternatives...>>::tag);
+};
+
+} // namespace dualis
@@ -0,0 +1,313 @@
+#pragma once
+
+#include "packing.h"
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <expected>
+#include <ranges>
+#include <type_traits>
+
+namespace dualis {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Variable-length integers
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+enum class _varint_order
+{
+    // The first byte holds the least significant 7 bits (LEB128, protocol buffers).
+    little_endian,
+    // The first byte holds the most significant 7 bits (MIDI, ASN.1 BER tags).
+    big_endian,
+};
+
+// Implements packing of integers into groups of 7 bits, one per byte, where the most significant
+// bit of each byte signals whether another byte follows. If ZigZag is true, signed values are
+// mapped onto unsigned ones first (0, -1, 1, -2, ... -> 0, 1, 2, 3, ...) so that small negative
+// values stay short.
+template <std::integral T, _varint_order Order, bool ZigZag> class _varint final
+{
+public:
+    using value_type = T;
+
+    // The maximum number of bytes a value of T takes.
+    static constexpr std::size_t max_size = (sizeof(T) * 8 + 6) / 7;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes, std::size_t& size) -> T
+    {
+        uint64_t groups = 0;
+        std::size_t i = 0;
+        while (i < max_size)
+        {
+            auto const byte = std::to_integer<uint64_t>(bytes[i++]);
+            if constexpr (Order == _varint_order::little_endian)
+            {
+                groups |= (byte & 0x7f) << (7 * (i - 1));
+            }
+            else
+            {
+                groups = (groups << 7) | (byte & 0x7f);
+            }
+            if ((byte & 0x80) == 0)
+            {
+                break;
+            }
+        }
+        size = i;
+        return _decode(groups);
+    }
+
+    // Like unpack, but reads at most available bytes and returns unpack_error::out_of_bounds if the
+    // value does not end within them.
+    [[nodiscard]] static auto try_unpack(const std::byte* bytes, std::size_t available,
+                                         std::size_t& size) -> std::expected<T, unpack_error>
+    {
+        // A zero byte after the available ones ends the value one byte too late.
+        std::byte padded[max_size]{};
+        if (available < max_size)
+        {
+            std::copy_n(bytes, available, padded);
+            bytes = padded;
+        }
+        auto const value = unpack(bytes, size);
+        if (size > available) [[unlikely]]
+        {
+            return std::unexpected{unpack_error::out_of_bounds};
+        }
+        return value;
+    }
+
+    // Unpacks a value from the first bytes of word, which holds 8 bytes loaded in little-endian
+    // order. Gathers the 7-bit groups using masks and shifts instead of a loop over the bytes. Sets
+    // size to 0 if the value does not end within these 8 bytes (or is malformed).
+    [[nodiscard]] static auto unpack_word(uint64_t word, std::size_t& size) noexcept -> T
+    {
+        auto const stops = ~word & 0x8080808080808080;
+        size = stops == 0 ? 0 : std::countr_zero(stops) / 8 + 1;
+        if (size == 0 || size > max_size)
+        {
+            size = 0;
+            return T{};
+        }
+        // All bits up to and including the most significant bit of the last byte.
+        auto groups = word & (stops ^ (stops - 1));
+        if constexpr (Order == _varint_order::big_endian)
+        {
+            groups = byte_swap(groups) >> (64 - 8 * size);
+        }
+        groups = (groups & 0x007f007f007f007f) | ((groups & 0x7f007f007f007f00) >> 1);
+        groups = (groups & 0x00003fff00003fff) | ((groups & 0x3fff00003fff0000) >> 2);
+        groups = (groups & 0x000000000fffffff) | ((groups & 0x0fffffff00000000) >> 4);
+        return _decode(groups);
+    }
+
+    static auto pack(std::byte* bytes, T value) -> std::size_t
+    {
+        auto groups = _encode(value);
+        if constexpr (Order == _varint_order::little_endian)
+        {
+            std::size_t i = 0;
+            for (; groups >= 0x80; groups >>= 7)
+            {
+                bytes[i++] = static_cast<std::byte>(groups | 0x80);
+            }
+            bytes[i++] = static_cast<std::byte>(groups);
+            return i;
+        }
+        else
+        {
+            auto const count = size(value);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                auto const continuation = i + 1 < count ? 0x80 : 0x00;
+                bytes[i] = static_cast<std::byte>(((groups >> (7 * (count - i - 1))) & 0x7f) |
+                                                  continuation);
+            }
+            return count;
+        }
+    }
+
+    [[nodiscard]] static auto size(T value) noexcept -> std::size_t
+    {
+        return std::max<std::size_t>(1, (std::bit_width(_encode(value)) + 6) / 7);
+    }
+
+private:
+    using unsigned_type = std::make_unsigned_t<T>;
+
+    [[nodiscard]] static auto _encode(T value) noexcept -> unsigned_type
+    {
+        if constexpr (ZigZag)
+        {
+            return static_cast<unsigned_type>(static_cast<unsigned_type>(value) << 1) ^
+                   static_cast<unsigned_type>(value >> (sizeof(T) * 8 - 1));
+        }
+        else
+        {
+            return static_cast<unsigned_type>(value);
+        }
+    }
+
+    [[nodiscard]] static auto _decode(uint64_t groups) noexcept -> T
+    {
+        auto const value = static_cast<unsigned_type>(groups);
+        if constexpr (ZigZag)
+        {
+            return static_cast<T>((value >> 1) ^ static_cast<unsigned_type>(-(value & 1)));
+        }
+        else
+        {
+            return static_cast<T>(value);
+        }
+    }
+};
+
+} // namespace detail
+
+// Unsigned LEB128, as used by DWARF, WebAssembly and protocol buffers.
+template <std::unsigned_integral T>
+using leb128 = detail::_varint<T, detail::_varint_order::little_endian, false>;
+
+// Signed integers mapped by zigzag encoding onto unsigned LEB128 (protocol buffers' sint32/sint64).
+template <std::signed_integral T>
+using zigzag_leb128 = detail::_varint<T, detail::_varint_order::little_endian, true>;
+
+// Variable-length quantities with the most significant group first, as used by MIDI.
+template <std::unsigned_integral T>
+using vlq = detail::_varint<T, detail::_varint_order::big_endian, false>;
+
+static_assert(variable_byte_packing<leb128<uint32_t>>);
+static_assert(variable_byte_packing<zigzag_leb128<int64_t>>);
+static_assert(variable_byte_packing<vlq<uint32_t>>);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Packing of variable-size values
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <variable_byte_packing Packing, byte_range Bytes>
+[[nodiscard]] auto unpack(const Bytes& bytes, std::size_t offset) -> typename Packing::value_type
+{
+    std::size_t size;
+    return Packing::unpack(std::ranges::cdata(bytes) + offset, size);
+}
+
+// A checked_variable_byte_packing can also unpack from a limited number of bytes. Its try_unpack
+// returns unpack_error::out_of_bounds instead of reading past them (see try_unpack below).
+template <class Packing>
+concept checked_variable_byte_packing =
+    variable_byte_packing<Packing> &&
+    requires(const std::byte* bytes, std::size_t available, std::size_t& size) {
+        {
+            Packing::try_unpack(bytes, available, size)
+        } -> std::same_as<std::expected<typename Packing::value_type, unpack_error>>;
+    };
+
+static_assert(checked_variable_byte_packing<leb128<uint32_t>>);
+static_assert(checked_variable_byte_packing<vlq<uint64_t>>);
+
+// Like unpack, but returns an unpack_error instead of reading past the end of bytes. Sets size to
+// the number of bytes the value takes.
+template <checked_variable_byte_packing Packing, byte_range Bytes>
+[[nodiscard]] auto try_unpack(const Bytes& bytes, std::size_t offset, std::size_t& size)
+    -> std::expected<typename Packing::value_type, unpack_error>
+{
+    auto const length = std::ranges::size(bytes);
+    if (offset > length) [[unlikely]]
+    {
+        return std::unexpected{unpack_error::out_of_bounds};
+    }
+    return Packing::try_unpack(std::ranges::cdata(bytes) + offset, length - offset, size);
+}
+
+// Returns the number of bytes written.
+template <variable_byte_packing Packing, class U, writable_byte_range Bytes>
+auto pack(Bytes& bytes, std::size_t offset, const U& value) -> std::size_t
+{
+    return Packing::pack(std::ranges::data(bytes) + offset, typename Packing::value_type(value));
+}
+
+namespace detail {
+
+template <class Packing>
+concept _word_variable_byte_packing =
+    variable_byte_packing<Packing> && requires(uint64_t word, std::size_t& size) {
+        { Packing::unpack_word(word, size) } -> std::same_as<typename Packing::value_type>;
+    };
+
+// Unpacks a value with either a fixed-size or a checked variable-size packing from at most
+// available bytes, and sets size to the number of bytes it takes.
+template <class Packing>
+requires byte_packing<Packing> || checked_variable_byte_packing<Packing>
+[[nodiscard]] auto _try_unpack_sized(const std::byte* bytes, std::size_t available,
+                                     std::size_t& size)
+    -> std::expected<typename Packing::value_type, unpack_error>
+{
+    if constexpr (byte_packing<Packing>)
+    {
+        size = Packing::size();
+        return try_unpack<Packing>(byte_span{bytes, available}, 0);
+    }
+    else
+    {
+        return Packing::try_unpack(bytes, available, size);
+    }
+}
+
+} // namespace detail
+
+// Unpacks count consecutive variable-size values into the given output iterator. Returns the offset
+// after the last value together with the advanced iterator. Packings that can unpack from a loaded
+// word (such as the varints above) decode 8 bytes at a time while enough bytes remain; runs of
+// single-byte values are emitted eight at once.
+template <variable_byte_packing Packing, byte_range Bytes, class Iterator>
+requires std::output_iterator<Iterator, typename Packing::value_type>
+auto unpack_varint_range(const Bytes& bytes, std::size_t offset, Iterator first, std::size_t count)
+    -> std::ranges::in_out_result<std::size_t, Iterator>
+{
+    auto const* data = std::ranges::cdata(bytes);
+    auto const length = std::ranges::size(bytes);
+    if constexpr (detail::_word_variable_byte_packing<Packing>)
+    {
+        while (count > 0 && offset + 8 <= length)
+        {
+            auto const word = uint64_le::unpack(data + offset);
+            if (count >= 8 && (word & 0x8080808080808080) == 0)
+            {
+                std::size_t size;
+                for (unsigned i = 0; i < 8; ++i)
+                {
+                    *first++ = Packing::unpack_word(word >> (8 * i), size);
+                }
+                offset += 8;
+                count -= 8;
+                continue;
+            }
+
+            std::size_t size;
+            auto const value = Packing::unpack_word(word, size);
+            if (size == 0)
+            {
+                // Longer than 8 bytes.
+                *first++ = Packing::unpack(data + offset, size);
+            }
+            else
+            {
+                *first++ = value;
+            }
+            offset += size;
+            --count;
+        }
+    }
+    for (; count > 0; --count)
+    {
+        std::size_t size;
+        *first++ = Packing::unpack(data + offset, size);
+        offset += size;
+    }
+    return {offset, first};
+}
+
+} // namespace dualis
@@ -0,0 +1,538 @@
+#pragma once
+
+#include "containers.h"
+#include "packing.h"
+#include "varint.h"
+#include <algorithm>
+#include <compare>
+#include <iterator>
+#include <ranges>
+#include <utility>
+
+namespace dualis {
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Views of packed values
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// A reference to a value packed with Packing that unpacks it on conversion and packs it on
+// assignment.
+template <byte_packing Packing> class _packed_reference
+{
+public:
+    using value_type = typename Packing::value_type;
+
+    explicit _packed_reference(std::byte* position) noexcept
+        : m_position{position}
+    {
+    }
+
+    _packed_reference(const _packed_reference&) = default;
+
+    // Assigning a reference assigns the referenced value, as for built-in references.
+    auto operator=(const _packed_reference& other) const -> const _packed_reference&
+    {
+        return *this = static_cast<value_type>(other);
+    }
+
+    auto operator=(const value_type& value) const -> const _packed_reference&
+    {
+        Packing::pack(m_position, value);
+        return *this;
+    }
+
+    operator value_type() const
+    {
+        return Packing::unpack(m_position);
+    }
+
+    template <class U> auto operator+=(const U& other) const -> const _packed_reference&
+    {
+        return *this = static_cast<value_type>(static_cast<value_type>(*this) + other);
+    }
+
+    template <class U> auto operator-=(const U& other) const -> const _packed_reference&
+    {
+        return *this = static_cast<value_type>(static_cast<value_type>(*this) - other);
+    }
+
+    template <class U> auto operator|=(const U& other) const -> const _packed_reference&
+    {
+        return *this = static_cast<value_type>(static_cast<value_type>(*this) | other);
+    }
+
+    template <class U> auto operator&=(const U& other) const -> const _packed_reference&
+    {
+        return *this = static_cast<value_type>(static_cast<value_type>(*this) & other);
+    }
+
+    template <class U> auto operator^=(const U& other) const -> const _packed_reference&
+    {
+        return *this = static_cast<value_type>(static_cast<value_type>(*this) ^ other);
+    }
+
+    // Swaps the referenced values, e.g. for std::ranges::sort.
+    friend void swap(const _packed_reference& lhs, const _packed_reference& rhs)
+    {
+        value_type const value = lhs;
+        lhs = static_cast<value_type>(rhs);
+        rhs = value;
+    }
+
+private:
+    std::byte* m_position;
+};
+
+// Random-access iterator over values packed with Packing. Dereferencing unpacks the value if Byte
+// is const, and returns a _packed_reference otherwise.
+template <byte_packing Packing, class Byte> class _packed_iterator
+{
+    static constexpr bool is_const = std::is_const_v<Byte>;
+
+public:
+    using iterator_concept = std::random_access_iterator_tag;
+    using iterator_category =
+        std::conditional_t<is_const, std::random_access_iterator_tag, std::input_iterator_tag>;
+    using value_type = typename Packing::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<is_const, value_type, _packed_reference<Packing>>;
+
+    _packed_iterator() = default;
+
+    explicit _packed_iterator(Byte* position) noexcept
+        : m_position{position}
+    {
+    }
+
+    [[nodiscard]] auto operator*() const -> reference
+    {
+        if constexpr (is_const)
+        {
+            return Packing::unpack(m_position);
+        }
+        else
+        {
+            return reference{m_position};
+        }
+    }
+
+    [[nodiscard]] auto operator[](difference_type n) const -> reference
+    {
+        return *(*this + n);
+    }
+
+    auto operator++() noexcept -> _packed_iterator&
+    {
+        m_position += Packing::size();
+        return *this;
+    }
+
+    auto operator++(int) noexcept -> _packed_iterator
+    {
+        auto const copy = *this;
+        ++*this;
+        return copy;
+    }
+
+    auto operator--() noexcept -> _packed_iterator&
+    {
+        m_position -= Packing::size();
+        return *this;
+    }
+
+    auto operator--(int) noexcept -> _packed_iterator
+    {
+        auto const copy = *this;
+        --*this;
+        return copy;
+    }
+
+    auto operator+=(difference_type n) noexcept -> _packed_iterator&
+    {
+        m_position += n * static_cast<difference_type>(Packing::size());
+        return *this;
+    }
+
+    auto operator-=(difference_type n) noexcept -> _packed_iterator&
+    {
+        return *this += -n;
+    }
+
+    [[nodiscard]] friend auto operator+(_packed_iterator it, difference_type n) noexcept
+        -> _packed_iterator
+    {
+        return it += n;
+    }
+
+    [[nodiscard]] friend auto operator+(difference_type n, _packed_iterator it) noexcept
+        -> _packed_iterator
+    {
+        return it += n;
+    }
+
+    [[nodiscard]] friend auto operator-(_packed_iterator it, difference_type n) noexcept
+        -> _packed_iterator
+    {
+        return it -= n;
+    }
+
+    [[nodiscard]] friend auto operator-(const _packed_iterator& lhs,
+                                        const _packed_iterator& rhs) noexcept -> difference_type
+    {
+        auto const distance = lhs.m_position - rhs.m_position;
+        return distance / static_cast<difference_type>(Packing::size());
+    }
+
+    [[nodiscard]] friend auto operator==(const _packed_iterator&, const _packed_iterator&) noexcept
+        -> bool = default;
+    [[nodiscard]] friend auto operator<=>(const _packed_iterator&,
+                                          const _packed_iterator&) noexcept = default;
+
+    // The address of the packed value.
+    [[nodiscard]] auto position() const noexcept -> Byte*
+    {
+        return m_position;
+    }
+
+private:
+    Byte* m_position{nullptr};
+};
+
+} // namespace detail
+
+// A view of consecutive values packed with Packing. The values are unpacked when they are accessed,
+// so creating a view neither copies nor unpacks anything.
+template <byte_packing Packing>
+class packed_view : public std::ranges::view_interface<packed_view<Packing>>
+{
+    static_assert(Packing::size() > 0);
+
+public:
+    using value_type = typename Packing::value_type;
+    using iterator = detail::_packed_iterator<Packing, const std::byte>;
+
+    packed_view() = default;
+
+    // Views all complete values in the given bytes.
+    explicit packed_view(byte_span bytes) noexcept
+        : packed_view{bytes, 0, bytes.size() / Packing::size()}
+    {
+    }
+
+    // Views count values starting at offset within the given bytes.
+    packed_view(byte_span bytes, std::size_t offset, std::size_t count) noexcept
+        : m_bytes{bytes.subspan(offset, count * Packing::size())}
+    {
+    }
+
+    [[nodiscard]] auto begin() const noexcept -> iterator
+    {
+        return iterator{m_bytes.data()};
+    }
+
+    [[nodiscard]] auto end() const noexcept -> iterator
+    {
+        return iterator{m_bytes.data() + m_bytes.size()};
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return m_bytes.size() / Packing::size();
+    }
+
+    // The packed bytes of all values.
+    [[nodiscard]] auto bytes() const noexcept -> byte_span
+    {
+        return m_bytes;
+    }
+
+    // Views count values (or all remaining values) starting at the value with the given index. An
+    // index past the end yields an empty view; count is clamped to the remaining values.
+    [[nodiscard]] auto subview(std::size_t first, std::size_t count = npos) const noexcept
+        -> packed_view
+    {
+        first = std::min(first, size());
+        return packed_view{m_bytes, first * Packing::size(), std::min(count, size() - first)};
+    }
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+private:
+    byte_span m_bytes;
+};
+
+// Unpacks all values of the view into the given output iterator. Unlike iterating the view, this
+// uses the packing's bulk path (such as vectorized byte swapping) if the output is contiguous.
+template <byte_packing Packing, class Iterator>
+requires std::output_iterator<Iterator, typename Packing::value_type>
+auto unpack_range(const packed_view<Packing>& view, Iterator first) -> Iterator
+{
+    return unpack_range<Packing>(view.bytes(), 0, first, view.size());
+}
+
+static_assert(std::ranges::random_access_range<packed_view<uint16_be>>);
+static_assert(std::ranges::sized_range<packed_view<uint16_be>>);
+static_assert(std::ranges::view<packed_view<uint16_be>>);
+
+// A view of consecutive values packed with Packing that can also be modified in place. Accessing a
+// value returns a proxy that unpacks the value when it is converted and packs it when it is
+// assigned, so that single values can be patched without unpacking (and repacking) all of them:
+//
+//     writable_packed_view<uint32_be> table{bytes, offset, count};
+//     table[i] += 0x200;
+template <byte_packing Packing>
+class writable_packed_view : public std::ranges::view_interface<writable_packed_view<Packing>>
+{
+    static_assert(Packing::size() > 0);
+
+public:
+    using value_type = typename Packing::value_type;
+    using iterator = detail::_packed_iterator<Packing, std::byte>;
+    using reference = detail::_packed_reference<Packing>;
+
+    writable_packed_view() = default;
+
+    // Views all complete values in the given bytes.
+    explicit writable_packed_view(writable_byte_span bytes) noexcept
+        : writable_packed_view{bytes, 0, bytes.size() / Packing::size()}
+    {
+    }
+
+    // Views count values starting at offset within the given bytes.
+    writable_packed_view(writable_byte_span bytes, std::size_t offset, std::size_t count) noexcept
+        : m_bytes{bytes.subspan(offset, count * Packing::size())}
+    {
+    }
+
+    [[nodiscard]] auto begin() const noexcept -> iterator
+    {
+        return iterator{m_bytes.data()};
+    }
+
+    [[nodiscard]] auto end() const noexcept -> iterator
+    {
+        return iterator{m_bytes.data() + m_bytes.size()};
+    }
+
+    [[nodiscard]] auto size() const noexcept -> std::size_t
+    {
+        return m_bytes.size() / Packing::size();
+    }
+
+    // The packed bytes of all values.
+    [[nodiscard]] auto bytes() const noexcept -> writable_byte_span
+    {
+        return m_bytes;
+    }
+
+    // Views count values (or all remaining values) starting at the value with the given index. An
+    // index past the end yields an empty view; count is clamped to the remaining values.
+    [[nodiscard]] auto subview(std::size_t first, std::size_t count = npos) const noexcept
+        -> writable_packed_view
+    {
+        first = std::min(first, size());
+        return writable_packed_view{m_bytes, first * Packing::size(),
+                                    std::min(count, size() - first)};
+    }
+
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    // Read-only views are cheaper to iterate, since dereferencing them needs no proxies.
+    operator packed_view<Packing>() const noexcept
+    {
+        return packed_view<Packing>{m_bytes};
+    }
+
+private:
+    writable_byte_span m_bytes;
+};
+
+// Packs all values of the given range into the view, which must be large enough. Uses the packing's
+// bulk path if the range is contiguous.
+template <byte_packing Packing, std::ranges::range Range>
+void pack_range(const writable_packed_view<Packing>& view, const Range& range)
+{
+    detail::_pack_all<Packing>(view.bytes().data(), range);
+}
+
+static_assert(std::ranges::random_access_range<writable_packed_view<uint16_be>>);
+static_assert(std::ranges::output_range<writable_packed_view<uint16_be>, uint16_t>);
+static_assert(std::ranges::view<writable_packed_view<uint16_be>>);
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+// Length-prefixed packings
+///////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// Unpacks or packs a length (or count) with either a fixed-size or a variable-size packing.
+template <class Packing>
+[[nodiscard]] auto _unpack_length(const std::byte* bytes, std::size_t& size) -> std::size_t
+{
+    if constexpr (byte_packing<Packing>)
+    {
+        size = Packing::size();
+        return static_cast<std::size_t>(Packing::unpack(bytes));
+    }
+    else
+    {
+        return static_cast<std::size_t>(Packing::unpack(bytes, size));
+    }
+}
+
+template <class Packing> [[nodiscard]] auto _length_size(std::size_t length) -> std::size_t
+{
+    if constexpr (byte_packing<Packing>)
+    {
+        return Packing::size();
+    }
+    else
+    {
+        return Packing::size(static_cast<typename Packing::value_type>(length));
+    }
+}
+
+template <class Packing> auto _pack_length(std::byte* bytes, std::size_t length) -> std::size_t
+{
+    auto const value = static_cast<typename Packing::value_type>(length);
+    if constexpr (byte_packing<Packing>)
+    {
+        Packing::pack(bytes, value);
+        return Packing::size();
+    }
+    else
+    {
+        return Packing::pack(bytes, value);
+    }
+}
+
+template <class Packing>
+concept _length_packing =
+    (byte_packing<Packing> || variable_byte_packing<Packing>) &&
+    std::integral<typename Packing::value_type>;
+
+// Unpacks a length from at most available bytes and checks that length units of unit_size bytes
+// follow it. Sets size to the number of bytes of the length and the units.
+template <class Packing>
+[[nodiscard]] auto _try_unpack_length(const std::byte* bytes, std::size_t available,
+                                      std::size_t unit_size, std::size_t& size)
+    -> std::expected<std::size_t, unpack_error>
+{
+    std::size_t length_size;
+    auto const length = _try_unpack_sized<Packing>(bytes, available, length_size);
+    if (!length)
+    {
+        return std::unexpected{length.error()};
+    }
+    if (std::cmp_less(*length, 0) ||
+        std::cmp_greater(*length, (available - length_size) / unit_size)) [[unlikely]]
+    {
+        return std::unexpected{unpack_error::out_of_bounds};
+    }
+    size = length_size + static_cast<std::size_t>(*length) * unit_size;
+    return static_cast<std::size_t>(*length);
+}
+
+} // namespace detail
+
+// Packs a sequence of bytes preceded by its length, which is packed with LengthPacking (e.g.
+// uint16_le or leb128<uint32_t>). Unpacking returns a byte_span into the packed bytes instead of a
+// copy, so the bytes must outlive it.
+template <detail::_length_packing LengthPacking> struct length_prefixed
+{
+    using value_type = byte_span;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes, std::size_t& size) -> byte_span
+    {
+        std::size_t length_size;
+        auto const length = detail::_unpack_length<LengthPacking>(bytes, length_size);
+        size = length_size + length;
+        return byte_span{bytes + length_size, length};
+    }
+
+    [[nodiscard]] static auto try_unpack(const std::byte* bytes, std::size_t available,
+                                         std::size_t& size)
+        -> std::expected<byte_span, unpack_error>
+    {
+        auto const length = detail::_try_unpack_length<LengthPacking>(bytes, available, 1, size);
+        if (!length)
+        {
+            return std::unexpected{length.error()};
+        }
+        return byte_span{bytes + size - *length, *length};
+    }
+
+    [[nodiscard]] static auto size(const byte_span& value) -> std::size_t
+    {
+        return detail::_length_size<LengthPacking>(value.size()) + value.size();
+    }
+
+    static auto pack(std::byte* bytes, const byte_span& value) -> std::size_t
+    {
+        auto const length_size = detail::_pack_length<LengthPacking>(bytes, value.size());
+        copy_bytes(bytes + length_size, value.data(), value.size());
+        return length_size + value.size();
+    }
+};
+
+// Packs an array of values packed with ElementPacking preceded by their count, which is packed with
+// CountPacking. Unpacking returns a packed_view into the packed bytes, which unpacks the elements
+// only when they are accessed.
+template <detail::_length_packing CountPacking, byte_packing ElementPacking> struct counted_array
+{
+    using value_type = packed_view<ElementPacking>;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes, std::size_t& size) -> value_type
+    {
+        std::size_t count_size;
+        auto const count = detail::_unpack_length<CountPacking>(bytes, count_size);
+        auto const length = count * ElementPacking::size();
+        size = count_size + length;
+        return value_type{byte_span{bytes + count_size, length}};
+    }
+
+    [[nodiscard]] static auto try_unpack(const std::byte* bytes, std::size_t available,
+                                         std::size_t& size)
+        -> std::expected<value_type, unpack_error>
+    {
+        constexpr auto element_size = ElementPacking::size();
+        auto const count =
+            detail::_try_unpack_length<CountPacking>(bytes, available, element_size, size);
+        if (!count)
+        {
+            return std::unexpected{count.error()};
+        }
+        auto const length = *count * element_size;
+        return value_type{byte_span{bytes + size - length, length}};
+    }
+
+    [[nodiscard]] static auto size(const value_type& value) -> std::size_t
+    {
+        return detail::_length_size<CountPacking>(value.size()) + value.bytes().size();
+    }
+
+    static auto pack(std::byte* bytes, const value_type& value) -> std::size_t
+    {
+        auto const count_size = detail::_pack_length<CountPacking>(bytes, value.size());
+        copy_bytes(bytes + count_size, value.bytes().data(), value.bytes().size());
+        return count_size + value.bytes().size();
+    }
+};
+
+static_assert(variable_byte_packing<length_prefixed<uint16_le>>);
+static_assert(variable_byte_packing<length_prefixed<leb128<uint32_t>>>);
+static_assert(variable_byte_packing<counted_array<uint32_be, uint16_be>>);
+static_assert(checked_variable_byte_packing<length_prefixed<leb128<uint32_t>>>);
+static_assert(checked_variable_byte_packing<counted_array<uint32_be, uint16_be>>);
+
+} // namespace dualis
+
+// Iterators of a packed_view point into the viewed bytes, not into the view itself.
+namespace std::ranges {
+template <class Packing>
+inline constexpr bool enable_borrowed_range<dualis::packed_view<Packing>> = true;
+template <class Packing>
+inline constexpr bool enable_borrowed_range<dualis::writable_packed_view<Packing>> = true;
+} // namespace std::ranges
@@ -0,0 +1,336 @@
+#include <catch2/catch_all.hpp>
+#include <dualis.h>
+#include <array>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+using namespace dualis;
+
+namespace {
+
+// Unpacks each field on its own, as tuple_packing did before adjacent fields were fused.
+template <byte_packing... Packings> struct field_by_field
+{
+    using value_type = std::tuple<typename Packings::value_type...>;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes) -> value_type
+    {
+        return _unpack(bytes, std::index_sequence_for<Packings...>{});
+    }
+
+    static void pack(std::byte* bytes, const value_type& value)
+    {
+        _pack(bytes, value, std::index_sequence_for<Packings...>{});
+    }
+
+    [[nodiscard]] static constexpr auto size()
+    {
+        return (Packings::size() + ...);
+    }
+
+private:
+    static constexpr std::array<std::size_t, sizeof...(Packings)> offsets = [] {
+        std::array<std::size_t, sizeof...(Packings)> sizes{Packings::size()...}, offsets{};
+        for (std::size_t i = 1; i < sizes.size(); ++i)
+        {
+            offsets[i] = offsets[i - 1] + sizes[i - 1];
+        }
+        return offsets;
+    }();
+
+    template <std::size_t... Indices>
+    [[nodiscard]] static auto _unpack(const std::byte* bytes, std::index_sequence<Indices...>)
+        -> value_type
+    {
+        return {Packings::unpack(bytes + offsets[Indices])...};
+    }
+
+    template <std::size_t... Indices>
+    static void _pack(std::byte* bytes, const value_type& value, std::index_sequence<Indices...>)
+    {
+        (Packings::pack(bytes + offsets[Indices], std::get<Indices>(value)), ...);
+    }
+};
+
+constexpr std::size_t record_count = 4096;
+
+template <class Packing> auto make_records() -> std::vector<std::byte>
+{
+    std::vector<std::byte> bytes(record_count * Packing::size());
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::byte>(i * 31 + 7);
+    }
+    return bytes;
+}
+
+template <class Packing> auto unpack_all(const std::vector<std::byte>& bytes) -> uint64_t
+{
+    uint64_t sum = 0;
+    for (std::size_t offset = 0; offset < bytes.size(); offset += Packing::size())
+    {
+        std::apply([&](auto... values) { ((sum += static_cast<uint64_t>(values)), ...); },
+                   Packing::unpack(bytes.data() + offset));
+    }
+    return sum;
+}
+
+template <class Packing> void repack_all(std::vector<std::byte>& bytes)
+{
+    for (std::size_t offset = 0; offset < bytes.size(); offset += Packing::size())
+    {
+        auto value = Packing::unpack(bytes.data() + offset);
+        std::get<0>(value) += 1;
+        Packing::pack(bytes.data() + offset, value);
+    }
+}
+
+template <byte_packing... Packings> void benchmark_layout()
+{
+    using fused = tuple_packing<Packings...>;
+    using reference = field_by_field<Packings...>;
+
+    auto bytes = make_records<fused>();
+    REQUIRE(unpack_all<fused>(bytes) == unpack_all<reference>(bytes));
+
+    BENCHMARK("unpack fused")
+    {
+        return unpack_all<fused>(bytes);
+    };
+    BENCHMARK("unpack field by field")
+    {
+        return unpack_all<reference>(bytes);
+    };
+    BENCHMARK("pack fused")
+    {
+        repack_all<fused>(bytes);
+        return bytes[0];
+    };
+    BENCHMARK("pack field by field")
+    {
+        repack_all<reference>(bytes);
+        return bytes[0];
+    };
+}
+
+} // namespace
+
+TEST_CASE("BMP info header", "[!benchmark][packing][tuple]")
+{
+    benchmark_layout<uint32_le, int32_le, int32_le, uint16_le, uint16_le, uint32_le, uint32_le,
+                     int32_le, int32_le, uint32_le, uint32_le>();
+}
+
+TEST_CASE("WAV fmt chunk", "[!benchmark][packing][tuple]")
+{
+    benchmark_layout<uint16_le, uint16_le, uint32_le, uint32_le, uint16_le, uint16_le>();
+}
+
+TEST_CASE("Small records", "[!benchmark][packing][tuple]")
+{
+    benchmark_layout<uint16_le, uint16_le, uint32_le>();
+}
+
+TEST_CASE("Runtime layout", "[!benchmark][packing][layout]")
+{
+    using packing = tuple_packing<uint32_le, int32_le, int32_le, uint16_le, uint16_le, uint32_le>;
+    std::vector<field_description> fields{
+        {"size", 0, 4, std::endian::little, field_kind::unsigned_integer},
+        {"width", 4, 4, std::endian::little, field_kind::signed_integer},
+        {"height", 8, 4, std::endian::little, field_kind::signed_integer},
+        {"planes", 12, 2, std::endian::little, field_kind::unsigned_integer},
+        {"bit_count", 14, 2, std::endian::little, field_kind::unsigned_integer},
+        {"compression", 16, 4, std::endian::little, field_kind::unsigned_integer},
+    };
+    layout const records{fields};
+    auto const bytes = make_records<packing>();
+    std::vector<uint64_t> columns(fields.size() * record_count);
+
+    // Dispatches on the description of every field of every record.
+    auto const interpret = [&] {
+        for (std::size_t i = 0; i < record_count; ++i)
+        {
+            auto const* record = bytes.data() + i * records.size();
+            for (std::size_t j = 0; j < fields.size(); ++j)
+            {
+                auto const& field = fields[j];
+                uint64_t value = 0;
+                switch (field.width)
+                {
+                case 2:
+                    value = field.kind == field_kind::signed_integer
+                                ? static_cast<uint64_t>(int16_le::unpack(record + field.offset))
+                                : uint16_le::unpack(record + field.offset);
+                    break;
+                case 4:
+                    value = field.kind == field_kind::signed_integer
+                                ? static_cast<uint64_t>(int32_le::unpack(record + field.offset))
+                                : uint32_le::unpack(record + field.offset);
+                    break;
+                }
+                columns[j * record_count + i] = value;
+            }
+        }
+        return columns[0];
+    };
+
+    BENCHMARK("unpack templated")
+    {
+        for (std::size_t i = 0; i < record_count; ++i)
+        {
+            std::apply(
+                [&, j = std::size_t{0}](auto... values) mutable {
+                    ((columns[j++ * record_count + i] = static_cast<uint64_t>(values)), ...);
+                },
+                packing::unpack(bytes.data() + i * packing::size()));
+        }
+        return columns[0];
+    };
+    BENCHMARK("unpack layout")
+    {
+        records.unpack(bytes, 0, record_count, columns);
+        return columns[0];
+    };
+    BENCHMARK("unpack field by field at runtime")
+    {
+        return interpret();
+    };
+}
+
+TEST_CASE("Parallel unpacking", "[!benchmark][packing][parallel]")
+{
+    constexpr std::size_t count = std::size_t{1} << 22;
+    std::vector<std::byte> bytes(count * uint32_be::size());
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::byte>(i * 131 + 7);
+    }
+    std::vector<uint32_t> values(count);
+
+    BENCHMARK("unpack serially")
+    {
+        unpack_range<uint32_be>(bytes, 0, values.begin(), count);
+        return values[0];
+    };
+    BENCHMARK("unpack in parallel")
+    {
+        unpack_range<uint32_be>(parallel_policy{}, bytes, 0, values.begin(), count);
+        return values[0];
+    };
+}
+
+TEST_CASE("Parallel packing of varints", "[!benchmark][packing][parallel][varint]")
+{
+    std::vector<uint64_t> values(std::size_t{1} << 22);
+    uint64_t state = 0x9e3779b97f4a7c15;
+    for (auto& value : values)
+    {
+        state = state * 6364136223846793005 + 1442695040888963407;
+        value = state >> (state % 64);
+    }
+
+    BENCHMARK("append one by one")
+    {
+        byte_vector bytes;
+        for (auto const value : values)
+        {
+            bytes.append_packed<leb128<uint64_t>>(value);
+        }
+        return bytes.size();
+    };
+    BENCHMARK("append serially")
+    {
+        byte_vector bytes;
+        return append_varint_range<leb128<uint64_t>>(bytes, values);
+    };
+    BENCHMARK("append in parallel")
+    {
+        byte_vector bytes;
+        return append_varint_range<leb128<uint64_t>>(parallel_policy{}, bytes, values);
+    };
+}
+
+TEST_CASE("Cyclic redundancy checks", "[!benchmark][checksum]")
+{
+    std::vector<std::byte> bytes(std::size_t{1} << 20);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::byte>((i * 2654435761u) >> 13);
+    }
+    auto const table = detail::_make_crc_kernels(false, false);
+
+    BENCHMARK("crc32 slicing-by-8")
+    {
+        return table.crc32(0, bytes.data(), bytes.size());
+    };
+    BENCHMARK("crc32")
+    {
+        return crc32(bytes);
+    };
+    BENCHMARK("crc32c slicing-by-8")
+    {
+        return table.crc32c(0, bytes.data(), bytes.size());
+    };
+    BENCHMARK("crc32c")
+    {
+        return crc32c(bytes);
+    };
+}
+
+TEST_CASE("Hashing", "[!benchmark][hash]")
+{
+    std::vector<std::byte> bytes(std::size_t{1} << 20);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::byte>((i * 2654435761u) >> 13);
+    }
+    // The byte-by-byte loop hand-written hashes typically use.
+    auto const fnv1a = [](byte_span bytes) {
+        uint64_t hash = 0xcbf29ce484222325;
+        for (auto const byte : bytes)
+        {
+            hash = (hash ^ std::to_integer<uint64_t>(byte)) * 0x100000001b3;
+        }
+        return hash;
+    };
+
+    BENCHMARK("fnv-1a")
+    {
+        return fnv1a(bytes);
+    };
+    BENCHMARK("xxh3_64")
+    {
+        return xxh3_64(bytes);
+    };
+    BENCHMARK("xxh3_128")
+    {
+        return xxh3_128(bytes).low;
+    };
+
+    std::unordered_map<byte_string, std::size_t, byte_hash, byte_equal> map;
+    for (std::size_t i = 0; i < 4096; ++i)
+    {
+        map.emplace(byte_span{bytes}.subspan(i * 7, 8 + i % 32), i);
+    }
+    BENCHMARK("look up spans")
+    {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < 4096; ++i)
+        {
+            found += map.count(byte_span{bytes}.subspan(i * 7, 8 + i % 32));
+        }
+        return found;
+    };
+    BENCHMARK("look up byte strings")
+    {
+        std::size_t found = 0;
+        for (std::size_t i = 0; i < 4096; ++i)
+        {
+            found += map.count(byte_string{byte_span{bytes}.subspan(i * 7, 8 + i % 32)});
+        }
+        return found;
+    };
+}
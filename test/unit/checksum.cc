@@ -0,0 +1,114 @@
+#include <catch2/catch_all.hpp>
+#include <dualis.h>
+#include <utility>
+#include <vector>
+
+using namespace dualis;
+using namespace dualis::literals;
+
+namespace {
+
+// Computes a CRC bit by bit to compare the kernels against.
+auto naive_crc(byte_span bytes, uint32_t polynomial) -> uint32_t
+{
+    uint32_t crc = ~uint32_t{0};
+    for (auto const byte : bytes)
+    {
+        crc ^= std::to_integer<uint32_t>(byte);
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc & 1) != 0 ? (crc >> 1) ^ polynomial : crc >> 1;
+        }
+    }
+    return ~crc;
+}
+
+// The combinations of extensions for which there are kernels, as far as the CPU supports them.
+auto supported_extensions() -> std::vector<std::pair<bool, bool>>
+{
+    auto const [sse42, pclmul] = detail::_detect_crc_support();
+    std::vector<std::pair<bool, bool>> extensions{{false, false}};
+    if (sse42)
+    {
+        extensions.emplace_back(true, false);
+    }
+    if (sse42 && pclmul)
+    {
+        extensions.emplace_back(true, true);
+    }
+    return extensions;
+}
+
+} // namespace
+
+SCENARIO("Cyclic redundancy checks", "[checksum]")
+{
+    GIVEN("the standard check input")
+    {
+        auto const bytes = "123456789"_bspan;
+
+        THEN("the checksums are the standard check values")
+        {
+            REQUIRE(crc32(bytes) == 0xcbf43926);
+            REQUIRE(crc32c(bytes) == 0xe3069283);
+            REQUIRE(crc32(byte_span{}) == 0);
+            REQUIRE(crc32c(byte_string{bytes}) == 0xe3069283);
+        }
+        THEN("checksums can be continued")
+        {
+            REQUIRE(crc32(bytes.subspan(4), crc32(bytes.first(4))) == 0xcbf43926);
+            REQUIRE(crc32c(bytes.subspan(4), crc32c(bytes.first(4))) == 0xe3069283);
+        }
+        THEN("checksums of parts can be combined")
+        {
+            for (std::size_t split = 0; split <= bytes.size(); ++split)
+            {
+                auto const first = bytes.first(split);
+                auto const second = bytes.subspan(split);
+                REQUIRE(crc32_combine(crc32(first), crc32(second), second.size()) == 0xcbf43926);
+                REQUIRE(crc32c_combine(crc32c(first), crc32c(second), second.size()) ==
+                        0xe3069283);
+            }
+        }
+    }
+    GIVEN("data of varying lengths and alignments")
+    {
+        std::vector<std::byte> data(4096 + 64);
+        for (std::size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<std::byte>((i * 2654435761u) >> 13);
+        }
+
+        THEN("every kernel matches the bitwise computation")
+        {
+            for (auto const& [sse42, pclmul] : supported_extensions())
+            {
+                INFO("sse4.2 " << sse42 << ", pclmul " << pclmul);
+                auto const kernels = detail::_make_crc_kernels(sse42, pclmul);
+                for (std::size_t offset = 0; offset < 16; offset += 3)
+                {
+                    for (std::size_t size = 0; size < 300; size += 1 + size / 16)
+                    {
+                        INFO("offset " << offset << ", size " << size);
+                        byte_span const bytes{data.data() + offset, size};
+                        REQUIRE(~kernels.crc32(~0u, bytes.data(), size) ==
+                                naive_crc(bytes, 0xedb88320));
+                        REQUIRE(~kernels.crc32c(~0u, bytes.data(), size) ==
+                                naive_crc(bytes, 0x82f63b78));
+                    }
+                }
+                byte_span const bytes{data.data() + 5, 4096 + 23};
+                REQUIRE(~kernels.crc32(~0u, bytes.data(), bytes.size()) ==
+                        naive_crc(bytes, 0xedb88320));
+                REQUIRE(~kernels.crc32c(~0u, bytes.data(), bytes.size()) ==
+                        naive_crc(bytes, 0x82f63b78));
+            }
+        }
+        THEN("long parts can be combined")
+        {
+            byte_span const bytes{data};
+            REQUIRE(crc32_combine(crc32(bytes.first(1000)), crc32(bytes.subspan(1000)),
+                                  bytes.size() - 1000) == crc32(bytes));
+        }
+    }
+}
@@ -0,0 +1,117 @@
+#include <catch2/catch_all.hpp>
+#include <dualis.h>
+#include <unordered_map>
+#include <vector>
+
+using namespace dualis;
+using namespace dualis::literals;
+
+namespace {
+
+auto supported_levels() -> std::vector<simd_level>
+{
+    std::vector<simd_level> levels;
+    for (auto level = simd_level::scalar; level <= detect_simd_level();
+         level = static_cast<simd_level>(static_cast<int>(level) + 1))
+    {
+        levels.push_back(level);
+    }
+    return levels;
+}
+
+} // namespace
+
+SCENARIO("XXH3 hashing", "[hash]")
+{
+    GIVEN("short inputs")
+    {
+        auto const bytes = "123456789"_bspan;
+
+        THEN("the hashes are those of the reference implementation")
+        {
+            REQUIRE(xxh3_64(byte_span{}) == 0x2d06800538d394c2);
+            REQUIRE(xxh3_64(bytes) == 0x72dcb18b67a17dff);
+            REQUIRE(xxh3_64(bytes, 42) == 0x6f803e3c27e6da22);
+            REQUIRE(xxh3_128(bytes) == hash128{0xe9716427681d5860, 0x33119477ede5dcd5});
+            REQUIRE(xxh3_64(byte_string{bytes}) == xxh3_64(bytes.data(), bytes.size()));
+        }
+    }
+    GIVEN("long inputs")
+    {
+        std::vector<std::byte> data(4096);
+        for (std::size_t i = 0; i < data.size(); ++i)
+        {
+            data[i] = static_cast<std::byte>(i);
+        }
+
+        THEN("the hashes are those of the reference implementation")
+        {
+            REQUIRE(xxh3_64(data) == 0xeb4b7c3707879151);
+            REQUIRE(xxh3_64(data, 42) == 0x0c535f8a1bfd00ad);
+            REQUIRE(xxh3_128(data) == hash128{0xeb4b7c3707879151, 0x03916578969f7a66});
+            REQUIRE(xxh3_128(data.data(), 200, 42) ==
+                    hash128{0x4329506fd5cc97ea, 0x925d43a3b9e488f2});
+        }
+        THEN("every kernel accumulates like the scalar one")
+        {
+            auto const scalar = detail::_make_hash_kernels(simd_level::scalar);
+            for (auto const level : supported_levels())
+            {
+                auto const kernels = detail::_make_hash_kernels(level);
+                for (std::size_t size = 241; size <= data.size(); size += 1 + size / 8)
+                {
+                    INFO("level " << simd_level_name(level) << ", size " << size);
+                    auto expected = detail::_xxh3_initial_acc;
+                    auto actual = detail::_xxh3_initial_acc;
+                    detail::_xxh3_accumulate_long(scalar, expected, data.data(), size,
+                                                  detail::_xxh3_secret.data());
+                    detail::_xxh3_accumulate_long(kernels, actual, data.data(), size,
+                                                  detail::_xxh3_secret.data());
+                    REQUIRE(actual == expected);
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Hashing byte containers", "[hash]")
+{
+    GIVEN("byte strings as keys of unordered containers")
+    {
+        byte_string const key{"key"_bspan};
+        byte_string const long_key{"a key longer than the embedded size"_bspan};
+        std::unordered_map<byte_string, int> standard{{key, 1}, {long_key, 2}};
+        std::unordered_map<byte_string, int, byte_hash, byte_equal> transparent{{key, 1},
+                                                                                {long_key, 2}};
+
+        THEN("std::hash hashes their contents")
+        {
+            REQUIRE(std::hash<byte_string>{}(key) == byte_hash{}("key"_bspan));
+            REQUIRE(std::hash<byte_vector>{}(byte_vector{"key"_bspan}) ==
+                    std::hash<byte_string>{}(key));
+            REQUIRE(standard.at(long_key) == 2);
+            REQUIRE(standard.find(byte_string{"other key"_bspan}) == standard.end());
+        }
+        THEN("they can be looked up by spans without constructing keys")
+        {
+            auto const bytes = "<a key longer than the embedded size>"_bspan;
+            REQUIRE(transparent.find(bytes.subspan(1, bytes.size() - 2))->second == 2);
+            REQUIRE(transparent.find("key"_bspan)->second == 1);
+            REQUIRE(transparent.find(bytes.first(4)) == transparent.end());
+            REQUIRE(transparent.count(byte_span{}) == 0);
+        }
+    }
+    GIVEN("byte ranges of different types")
+    {
+        auto const bytes = "abc"_bspan;
+        std::vector<std::byte> const vector(bytes.begin(), bytes.end());
+
+        THEN("they compare equal if their contents are equal")
+        {
+            REQUIRE(byte_equal{}(vector, byte_string{"abc"_bspan}));
+            REQUIRE(byte_equal{}(byte_span{}, byte_vector{}));
+            REQUIRE_FALSE(byte_equal{}(vector, bytes.first(2)));
+            REQUIRE_FALSE(byte_equal{}(vector, "abd"_bspan));
+        }
+    }
+}
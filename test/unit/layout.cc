@@ -0,0 +1,102 @@
+#include <catch2/catch_all.hpp>
+#include <dualis.h>
+#include <vector>
+
+using namespace dualis;
+using namespace dualis::literals;
+
+SCENARIO("Runtime layouts", "[layout]")
+{
+    GIVEN("a layout of mixed fields with a gap")
+    {
+        layout const records{{
+            {"id", 0, 2, std::endian::little, field_kind::unsigned_integer},
+            {"delta", 2, 3, std::endian::little, field_kind::signed_integer},
+            {"size", 8, 4, std::endian::big, field_kind::unsigned_integer},
+            {"scale", 12, 4, std::endian::little, field_kind::floating_point},
+            {"flags", 16, 1, std::endian::little, field_kind::unsigned_integer},
+        }};
+
+        THEN("adjacent fields share loads")
+        {
+            REQUIRE(records.size() == 17);
+            REQUIRE(records.operation_count() == 4);
+            REQUIRE(records.index_of("size") == 2);
+            REQUIRE_FALSE(records.index_of("missing"));
+        }
+
+        WHEN("unpacking a batch of records")
+        {
+            using reference = tuple_packing<uint16_le, int24_le, raw<std::array<uint8_t, 3>>,
+                                            uint32_be, float32_le, raw<uint8_t>>;
+            byte_vector bytes;
+            bytes.append(1, 0xee_b);
+            for (uint16_t i = 0; i < 20; ++i)
+            {
+                bytes.append_packed<reference>(
+                    {i, -i * 1000, {}, 0x01020304u * i, 0.5f * i, static_cast<uint8_t>(i)});
+            }
+            auto const columns = records.unpack(bytes, 1, 20);
+
+            THEN("every field is stored in its column")
+            {
+                REQUIRE(columns.size() == 5 * 20);
+                for (uint16_t i = 0; i < 20; ++i)
+                {
+                    auto const value = unpack<reference>(bytes, 1 + i * reference::size());
+                    REQUIRE(columns[i] == std::get<0>(value));
+                    REQUIRE(layout::as_int64(columns[20 + i]) == std::get<1>(value));
+                    REQUIRE(columns[40 + i] == std::get<3>(value));
+                    REQUIRE(layout::as_double(columns[60 + i]) == std::get<4>(value));
+                    REQUIRE(columns[80 + i] == std::get<5>(value));
+                }
+            }
+        }
+        WHEN("the records exceed the bytes")
+        {
+            std::vector<std::byte> bytes(2 * 17);
+
+            THEN("unpacking throws")
+            {
+                REQUIRE_THROWS_AS(records.unpack(bytes, 1, 2), std::out_of_range);
+                REQUIRE(records.unpack(bytes, 0, 2).size() == 10);
+            }
+        }
+    }
+    GIVEN("big endian fields in a padded record")
+    {
+        layout const records{{{"b", 1, 1, std::endian::big, field_kind::signed_integer},
+                              {"a", 0, 1, std::endian::big, field_kind::unsigned_integer},
+                              {"c", 2, 6, std::endian::big, field_kind::unsigned_integer},
+                              {"d", 8, 8, std::endian::big, field_kind::floating_point}},
+                             20};
+        byte_vector bytes;
+        bytes.append_packed<tuple_packing<raw<uint8_t>, raw<int8_t>, uint48_be, float64_be>>(
+            {0x80, -2, 0x010203040506, -1.25});
+        bytes.resize(20);
+
+        THEN("the fields are unpacked in declaration order")
+        {
+            REQUIRE(records.size() == 20);
+            REQUIRE(records.operation_count() == 2);
+            auto const columns = records.unpack(bytes, 0, 1);
+            REQUIRE(layout::as_int64(columns[0]) == -2);
+            REQUIRE(columns[1] == 0x80);
+            REQUIRE(columns[2] == 0x010203040506);
+            REQUIRE(layout::as_double(columns[3]) == -1.25);
+        }
+    }
+    GIVEN("malformed descriptions")
+    {
+        THEN("the layout cannot be created")
+        {
+            REQUIRE_THROWS_AS(layout({{"a", 0, 9}}), std::invalid_argument);
+            REQUIRE_THROWS_AS(
+                layout({{"a", 0, 2, std::endian::little, field_kind::floating_point}}),
+                std::invalid_argument);
+            REQUIRE_THROWS_AS(layout({{"a", 4, 4}}, 6), std::invalid_argument);
+            REQUIRE_THROWS_AS(layout({{"a", std::size_t{1} << 32, 4}}), std::invalid_argument);
+            REQUIRE_THROWS_AS(layout({{"a", ~std::size_t{0}, 2}}), std::invalid_argument);
+        }
+    }
+}
@@ -1,5 +1,6 @@
 #include <catch2/catch_all.hpp>
 #include <dualis.h>
+#include <array>
 #include <vector>
 
 using namespace dualis;
@@ -80,4 +81,855 @@ SCENARIO("Packing into bytes", "[packing]")
             REQUIRE(std::to_integer<int>(bytes[1]) == (1111 >> 8));
         }
     }
-}
\ No newline at end of file
+}
+
+SCENARIO("Tuple packing of mixed layouts", "[packing][tuple]")
+{
+    // Adjacent little endian fields are fused into one load or store; the big endian field and the
+    // trailing byte are packed on their own.
+    using packing = tuple_packing<raw<uint8_t>, raw<int8_t>, int16_le, uint32_le, uint16_be,
+                                  int32_le, uint16_le, raw<uint8_t>>;
+    static_assert(packing::size() == 17);
+
+    GIVEN("a sequence of bytes")
+    {
+        std::vector<std::byte> bytes{0x01_b, 0xfe_b, 0x34_b, 0x92_b, 0x78_b, 0x56_b,
+                                     0x34_b, 0x12_b, 0xab_b, 0xcd_b, 0xff_b, 0xff_b,
+                                     0xff_b, 0xff_b, 0x22_b, 0x11_b, 0x7f_b};
+
+        WHEN("unpacking the tuple")
+        {
+            auto const value = unpack<packing>(bytes, 0);
+
+            THEN("all values are correct")
+            {
+                REQUIRE(std::get<0>(value) == 0x01);
+                REQUIRE(std::get<1>(value) == -2);
+                REQUIRE(std::get<2>(value) == static_cast<int16_t>(0x9234));
+                REQUIRE(std::get<3>(value) == 0x12345678);
+                REQUIRE(std::get<4>(value) == 0xabcd);
+                REQUIRE(std::get<5>(value) == -1);
+                REQUIRE(std::get<6>(value) == 0x1122);
+                REQUIRE(std::get<7>(value) == 0x7f);
+            }
+            THEN("packing the tuple restores the bytes")
+            {
+                std::vector<std::byte> packed(bytes.size());
+                pack<packing>(packed, 0, value);
+                REQUIRE(packed == bytes);
+            }
+            THEN("packing the values restores the bytes")
+            {
+                std::vector<std::byte> packed(bytes.size());
+                std::apply(
+                    [&](auto... values) {
+                        pack_tuple<raw<uint8_t>, raw<int8_t>, int16_le, uint32_le, uint16_be,
+                                   int32_le, uint16_le, raw<uint8_t>>(packed, 0, values...);
+                    },
+                    value);
+                REQUIRE(packed == bytes);
+            }
+        }
+    }
+}
+
+SCENARIO("Tuple packing with pseudo packings", "[packing][tuple]")
+{
+    using header = tuple_packing<uint16_le, skip<2>, raw<uint8_t>, align<4>, uint32_be,
+                                 pad<2, 0xee_b>, uint16_le>;
+    static_assert(
+        std::same_as<header::value_type, std::tuple<uint16_t, uint8_t, uint32_t, uint16_t>>);
+    static_assert(header::size() == 16);
+
+    GIVEN("a header with reserved bytes and padding")
+    {
+        std::vector<std::byte> const bytes{0x34_b, 0x12_b, 0xaa_b, 0xbb_b, 0x07_b, 0xcc_b,
+                                           0xdd_b, 0xee_b, 0x01_b, 0x02_b, 0x03_b, 0x04_b,
+                                           0xee_b, 0xee_b, 0xff_b, 0x00_b};
+
+        THEN("only the fields are unpacked")
+        {
+            auto const [magic, kind, size, count] = unpack_tuple<uint16_le, skip<2>, raw<uint8_t>,
+                                                                 align<4>, uint32_be, pad<2>,
+                                                                 uint16_le>(bytes, 0);
+            REQUIRE(magic == 0x1234);
+            REQUIRE(kind == 7);
+            REQUIRE(size == 0x01020304);
+            REQUIRE(count == 0xff);
+        }
+        THEN("packing fills the padding and leaves skipped bytes unchanged")
+        {
+            std::vector<std::byte> packed(bytes.size(), 0xaa_b);
+            pack<header>(packed, 0, unpack<header>(bytes, 0));
+            REQUIRE(packed[2] == 0xaa_b);
+            REQUIRE(packed[5] == 0x00_b);
+            REQUIRE(packed[12] == 0xee_b);
+
+            std::ranges::copy(std::span{bytes}.subspan(2, 2), packed.begin() + 2);
+            std::ranges::copy(std::span{bytes}.subspan(5, 3), packed.begin() + 5);
+            REQUIRE(packed == bytes);
+        }
+        THEN("the values can be packed without a tuple")
+        {
+            std::vector<std::byte> packed(bytes.size());
+            pack_tuple<uint16_le, skip<2>, raw<uint8_t>, align<4>, uint32_be, pad<2, 0xee_b>,
+                       uint16_le>(packed, 0, 0x1234, 7, 0x01020304, 0xff);
+            REQUIRE(unpack<header>(packed, 0) == unpack<header>(bytes, 0));
+            REQUIRE(packed[12] == 0xee_b);
+        }
+    }
+}
+
+SCENARIO("Signature packings", "[packing][tuple][signature]")
+{
+    using wave = tuple_packing<expect_bytes<"RIFF">, uint32_le, expect_bytes<"WAVE">,
+                               expect<uint32_be, 0x666d7420>, uint32_le>;
+    static_assert(std::same_as<wave::value_type, std::tuple<uint32_t, uint32_t>>);
+    static_assert(wave::size() == 20);
+
+    GIVEN("a WAVE header")
+    {
+        auto const header = "RIFF\x24\0\0\0WAVEfmt \x10\0\0\0"_bspan;
+        std::vector<std::byte> bytes(header.begin(), header.end());
+
+        THEN("the constant bytes match")
+        {
+            REQUIRE(matches<wave>(bytes, 0));
+            REQUIRE(matches<expect_bytes<"WAVE">>(bytes, 8));
+            REQUIRE(matches<expect<uint16_le, 0x4952>>(bytes, 0));
+            REQUIRE_FALSE(matches<expect_bytes<"WAVE">>(bytes, 0));
+            REQUIRE_FALSE(matches<wave>(bytes, 1));
+            REQUIRE_FALSE(matches<expect_bytes<"WAVE">>(bytes, 18));
+        }
+        THEN("only the other fields are unpacked")
+        {
+            REQUIRE(try_unpack<wave>(bytes, 0) == std::tuple{36u, 16u});
+            REQUIRE(unpack<wave>(bytes, 0) == std::tuple{36u, 16u});
+        }
+        THEN("packing writes the constant bytes")
+        {
+            std::vector<std::byte> packed(bytes.size());
+            pack_tuple<expect_bytes<"RIFF">, uint32_le, expect_bytes<"WAVE">,
+                       expect<uint32_be, 0x666d7420>, uint32_le>(packed, 0, 36, 16);
+            REQUIRE(packed == bytes);
+        }
+        WHEN("a constant byte differs")
+        {
+            auto const index = GENERATE(0, 3, 8, 12, 15);
+            bytes[index] ^= 0x20_b;
+
+            THEN("checked unpacking rejects the bytes")
+            {
+                REQUIRE_FALSE(matches<wave>(bytes, 0));
+                REQUIRE(try_unpack<wave>(bytes, 0).error() == unpack_error::mismatch);
+                std::vector<wave::value_type> values;
+                REQUIRE(try_unpack_range<wave>(bytes, 0, std::back_inserter(values), 1).error() ==
+                        unpack_error::mismatch);
+            }
+        }
+        WHEN("a field differs")
+        {
+            bytes[4] = 0xff_b;
+
+            THEN("the constant bytes still match")
+            {
+                REQUIRE(matches<wave>(bytes, 0));
+            }
+        }
+    }
+}
+
+SCENARIO("Unpacking records into columns", "[packing][records]")
+{
+    using record =
+        tuple_packing<uint32_be, raw<uint8_t>, float32_le, int64_le, uint16_be, int24_le>;
+    constexpr std::size_t count = 41;
+
+    GIVEN("an array of records")
+    {
+        std::vector<std::byte> bytes(2 + count * record::size());
+        for (std::size_t i = 0; i < bytes.size(); ++i)
+        {
+            bytes[i] = static_cast<std::byte>(i * 13 + 5);
+        }
+
+        WHEN("unpacking the records into vectors")
+        {
+            auto const [ids, kinds, weights, times, flags, deltas] =
+                unpack_records<uint32_be, raw<uint8_t>, float32_le, int64_le, uint16_be, int24_le>(
+                    bytes, 2, count);
+
+            THEN("each column holds one field of all records")
+            {
+                REQUIRE(ids.size() == count);
+                for (std::size_t i = 0; i < count; ++i)
+                {
+                    auto const [id, kind, weight, time, flag, delta] =
+                        unpack<record>(bytes, 2 + i * record::size());
+                    REQUIRE(ids[i] == id);
+                    REQUIRE(kinds[i] == kind);
+                    REQUIRE(std::bit_cast<uint32_t>(weights[i]) == std::bit_cast<uint32_t>(weight));
+                    REQUIRE(times[i] == time);
+                    REQUIRE(flags[i] == flag);
+                    REQUIRE(deltas[i] == delta);
+                }
+            }
+            THEN("packing the columns restores the records")
+            {
+                std::vector<std::byte> packed(bytes.size(), bytes[0]);
+                packed[1] = bytes[1];
+                pack_records<uint32_be, raw<uint8_t>, float32_le, int64_le, uint16_be, int24_le>(
+                    packed, 2, ids, kinds, weights, times, flags, deltas);
+                REQUIRE(packed == bytes);
+            }
+        }
+        WHEN("unpacking into caller-provided columns")
+        {
+            std::vector<uint16_t> first(count + 5);
+            std::array<uint8_t, 3> second{};
+            unpack_records<uint16_be, raw<uint8_t>>(bytes, 0, first, second);
+
+            THEN("as many records as the shortest column holds are unpacked")
+            {
+                REQUIRE(first[2] == unpack<uint16_be>(bytes, 6));
+                REQUIRE(second[2] == unpack<raw<uint8_t>>(bytes, 8));
+                REQUIRE(first[3] == 0);
+            }
+        }
+    }
+}
+
+SCENARIO("Checked unpacking", "[unpacking][checked]")
+{
+    GIVEN("a sequence of bytes")
+    {
+        std::vector<std::byte> bytes{0x80_b, 0x10_b, 0x11_b, 0x12_b, 0x13_b};
+
+        THEN("values within the bytes are unpacked")
+        {
+            REQUIRE(try_unpack<uint32_le>(bytes, 1) == 0x13121110);
+            REQUIRE(try_unpack_tuple<uint16_le, uint16_be>(bytes, 0) ==
+                    std::tuple<uint16_t, uint16_t>{0x1080, 0x1112});
+
+            std::vector<uint16_t> values(2);
+            auto const last = try_unpack_range<uint16_be>(bytes, 1, values.begin(), 2);
+            REQUIRE(last == values.end());
+            REQUIRE(values == std::vector<uint16_t>{0x1011, 0x1213});
+        }
+        THEN("values exceeding the bytes are rejected")
+        {
+            REQUIRE(try_unpack<uint32_le>(bytes, 2) ==
+                    std::unexpected{unpack_error::out_of_bounds});
+            REQUIRE_FALSE(try_unpack<uint16_le>(bytes, 6).has_value());
+            REQUIRE_FALSE(try_unpack<uint16_le>(bytes, std::size_t(-1)).has_value());
+            REQUIRE_FALSE((try_unpack_tuple<uint16_le, uint16_le>(bytes, 2).has_value()));
+
+            std::vector<uint16_t> values(3, 0);
+            REQUIRE_FALSE(try_unpack_range<uint16_le>(bytes, 0, values.begin(), 3).has_value());
+            REQUIRE_FALSE(
+                try_unpack_range<uint16_le>(bytes, 0, values.begin(), std::size_t(-1) / 2 + 2)
+                    .has_value());
+            REQUIRE(values == std::vector<uint16_t>(3, 0));
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("Bulk unpacking and packing of big endian integers", "[packing][bulk]",
+                   uint16_t, int32_t, uint64_t)
+{
+    using packing = big_endian<TestType>;
+    // An odd count exercises both the vectorized loop and the scalar remainder.
+    constexpr std::size_t count = 37;
+    std::vector<std::byte> bytes(count * sizeof(TestType) + 1);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::byte>(i * 7 + 3);
+    }
+
+    std::vector<TestType> values(count);
+    auto const after = unpack_range<packing>(bytes, 1, values.begin(), count);
+    REQUIRE(after == values.end());
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        REQUIRE(values[i] == unpack<packing>(bytes, 1 + i * sizeof(TestType)));
+    }
+
+    std::vector<std::byte> packed(bytes.size(), 0x00_b);
+    pack_range<packing>(packed, 1, values);
+    REQUIRE(std::equal(bytes.begin() + 1, bytes.end(), packed.begin() + 1));
+
+    std::vector<std::byte> packed_iter(bytes.size(), 0x00_b);
+    pack_range<packing>(packed_iter, 1, values.cbegin(), values.cend());
+    REQUIRE(packed_iter == packed);
+}
+
+TEMPLATE_TEST_CASE("Bulk unpacking and packing of native integers", "[packing][bulk]", uint16_le,
+                   int32_le, uint64_le, raw<uint32_t>, raw<int8_t>)
+{
+    using value_type = typename TestType::value_type;
+    static_assert(bulk_byte_packing<TestType>);
+    constexpr std::size_t count = 37;
+    std::vector<std::byte> bytes(count * sizeof(value_type) + 1);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::byte>(i * 7 + 3);
+    }
+
+    std::vector<value_type> values(count);
+    unpack_range<TestType>(bytes, 1, values.begin(), count);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        REQUIRE(values[i] == unpack<TestType>(bytes, 1 + i * sizeof(value_type)));
+    }
+
+    std::vector<std::byte> packed(bytes.size(), bytes[0]);
+    pack_range<TestType>(packed, 1, values);
+    REQUIRE(packed == bytes);
+
+    byte_vector appended;
+    appended.append_packed_range<TestType>(values);
+    REQUIRE(std::equal(appended.begin(), appended.end(), bytes.begin() + 1, bytes.end()));
+    appended.insert_packed_range<TestType>(0, std::vector<value_type>{values[1]});
+    REQUIRE(unpack<TestType>(appended, 0) == values[1]);
+    REQUIRE(std::equal(appended.begin() + sizeof(value_type), appended.end(), bytes.begin() + 1,
+                       bytes.end()));
+}
+
+SCENARIO("Arbitrary-width integer packing", "[packing][integers]")
+{
+    GIVEN("a sequence of bytes")
+    {
+        std::vector<std::byte> bytes{0x01_b, 0x02_b, 0x83_b, 0x04_b, 0x05_b, 0x86_b};
+
+        THEN("24-bit integers are unpacked correctly")
+        {
+            REQUIRE(unpack<uint24_le>(bytes, 0) == 0x830201);
+            REQUIRE(unpack<uint24_be>(bytes, 0) == 0x010283);
+            REQUIRE(unpack<int24_le>(bytes, 0) == 0x830201 - 0x1000000);
+            REQUIRE(unpack<int24_be>(bytes, 0) == 0x010283);
+        }
+        THEN("48-bit integers are unpacked correctly")
+        {
+            REQUIRE(unpack<uint48_le>(bytes, 0) == 0x860504830201);
+            REQUIRE(unpack<uint48_be>(bytes, 0) == 0x010283040586);
+            REQUIRE(unpack<int_le<6>>(bytes, 0) == 0x860504830201 - 0x1000000000000);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("Arbitrary-width integer round trips", "[packing][integers]", uint_le<1>,
+                   int_be<2>, int_le<3>, uint_be<3>, int_be<5>, uint_le<6>, int_le<7>, uint_be<7>,
+                   int_be<8>)
+{
+    using value_type = typename TestType::value_type;
+    constexpr auto width = TestType::size();
+    constexpr bool big_endian = std::is_same_v<TestType, uint_be<width>> ||
+                                std::is_same_v<TestType, int_be<width>>;
+
+    auto bytes = std::vector<std::byte>(width * 64);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::byte>(i * 97 + 13);
+    }
+    for (std::size_t offset = 0; offset + width <= bytes.size(); offset += width)
+    {
+        uint64_t expected = 0;
+        for (std::size_t i = 0; i < width; ++i)
+        {
+            auto const index = offset + (big_endian ? i : width - 1 - i);
+            expected = (expected << 8) | std::to_integer<uint64_t>(bytes[index]);
+        }
+        if (std::is_signed_v<value_type> && width < 8 && (expected >> (8 * width - 1)) != 0)
+        {
+            expected -= uint64_t{1} << (8 * width);
+        }
+
+        auto const value = unpack<TestType>(bytes, offset);
+        REQUIRE(value == static_cast<value_type>(expected));
+
+        std::vector<std::byte> packed(width);
+        pack<TestType>(packed, 0, value);
+        REQUIRE(std::equal(packed.begin(), packed.end(), bytes.begin() + offset));
+    }
+}
+
+TEMPLATE_TEST_CASE("Bulk unpacking of 24-bit integers", "[packing][bulk]", uint24_le, uint24_be,
+                   int24_le, int24_be)
+{
+    for (std::size_t count : {0, 3, 8, 29, 100})
+    {
+        std::vector<std::byte> bytes(count * 3 + 1);
+        for (std::size_t i = 0; i < bytes.size(); ++i)
+        {
+            bytes[i] = static_cast<std::byte>(i * 59 + 1);
+        }
+
+        std::vector<typename TestType::value_type> values(count);
+        unpack_range<TestType>(bytes, 1, values.begin(), count);
+        INFO("count " << count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            REQUIRE(values[i] == unpack<TestType>(bytes, 1 + i * 3));
+        }
+
+        std::vector<std::byte> packed(bytes.size(), bytes[0]);
+        pack_range<TestType>(packed, 1, values);
+        REQUIRE(packed == bytes);
+    }
+}
+
+SCENARIO("Variable-length integer packing", "[packing][varint]")
+{
+    GIVEN("well-known encodings")
+    {
+        std::vector<std::byte> bytes{0xe5_b, 0x8e_b, 0x26_b, 0x7f_b, 0x81_b, 0x80_b, 0x00_b};
+
+        THEN("unsigned LEB128 values are unpacked correctly")
+        {
+            REQUIRE(unpack<leb128<uint32_t>>(bytes, 0) == 624485);
+            REQUIRE(leb128<uint32_t>::size(624485) == 3);
+        }
+        THEN("zigzag LEB128 values are unpacked correctly")
+        {
+            REQUIRE(unpack<zigzag_leb128<int32_t>>(bytes, 3) == -64);
+        }
+        THEN("MIDI variable-length quantities are unpacked correctly")
+        {
+            REQUIRE(unpack<vlq<uint32_t>>(bytes, 4) == 0x4000);
+            REQUIRE(vlq<uint32_t>::size(0x4000) == 3);
+        }
+        THEN("a byte_stream advances by the size of each value")
+        {
+            byte_stream stream{bytes};
+            REQUIRE(stream.unpack<leb128<uint32_t>>() == 624485);
+            REQUIRE(stream.unpack<zigzag_leb128<int32_t>>() == -64);
+            REQUIRE(stream.tellg() == 4);
+        }
+        THEN("checked unpacking stops at the end of the bytes")
+        {
+            std::size_t size = 0;
+            REQUIRE(try_unpack<leb128<uint32_t>>(byte_span{bytes}.first(3), 0, size) == 624485);
+            REQUIRE(size == 3);
+            REQUIRE(try_unpack<leb128<uint32_t>>(byte_span{bytes}.first(2), 0, size).error() ==
+                    unpack_error::out_of_bounds);
+            REQUIRE(try_unpack<vlq<uint32_t>>(byte_span{bytes}.first(6), 4, size).error() ==
+                    unpack_error::out_of_bounds);
+            REQUIRE(try_unpack<vlq<uint32_t>>(bytes, 7, size).error() ==
+                    unpack_error::out_of_bounds);
+            REQUIRE(try_unpack<vlq<uint32_t>>(bytes, 8, size).error() ==
+                    unpack_error::out_of_bounds);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("Variable-length integer round trips", "[packing][varint]", leb128<uint32_t>,
+                   leb128<uint64_t>, zigzag_leb128<int32_t>, zigzag_leb128<int64_t>,
+                   vlq<uint32_t>, vlq<uint16_t>)
+{
+    using value_type = typename TestType::value_type;
+    std::vector<value_type> values;
+    uint64_t state = 1;
+    for (int i = 0; i < 500; ++i)
+    {
+        state = state * 6364136223846793005 + 1442695040888963407;
+        // Mostly small values, with the occasional large one.
+        auto const bits = i % 5 == 0 ? 64 : (state >> 60) + 1;
+        values.push_back(static_cast<value_type>(bits == 64 ? state : state >> (64 - bits)));
+    }
+
+    byte_vector bytes;
+    for (auto const value : values)
+    {
+        bytes.append_packed<TestType>(value);
+    }
+
+    std::vector<value_type> unpacked(values.size());
+    auto const [offset, last] =
+        unpack_varint_range<TestType>(bytes, 0, unpacked.begin(), values.size());
+    REQUIRE(offset == bytes.size());
+    REQUIRE(last == unpacked.end());
+    REQUIRE(unpacked == values);
+
+    std::vector<value_type> streamed;
+    byte_stream stream{bytes};
+    stream.unpack_range<TestType>(std::back_inserter(streamed), values.size());
+    REQUIRE(stream.tellg() == bytes.size());
+    REQUIRE(streamed == values);
+}
+
+SCENARIO("Floating-point packing", "[packing][float]")
+{
+    GIVEN("a sequence of bytes")
+    {
+        std::vector<std::byte> bytes{0x3f_b, 0x80_b, 0x00_b, 0x00_b, 0x00_b, 0x00_b,
+                                     0x00_b, 0x00_b, 0x00_b, 0x00_b, 0x04_b, 0xc0_b};
+
+        THEN("the values are correct")
+        {
+            REQUIRE(unpack<float32_be>(bytes, 0) == 1.0f);
+            REQUIRE(unpack<float64_le>(bytes, 4) == -2.5);
+        }
+        WHEN("packing values")
+        {
+            std::vector<std::byte> packed(bytes.size());
+            pack<float32_be>(packed, 0, 1.0f);
+            pack<float64_le>(packed, 4, -2.5);
+
+            THEN("the bytes are correct")
+            {
+                REQUIRE(packed == bytes);
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE("Bulk floating-point packing", "[packing][float][bulk]", float32_le, float32_be,
+                   float64_le, float64_be)
+{
+    using value_type = typename TestType::value_type;
+    std::vector<value_type> values(37);
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        values[i] = static_cast<value_type>(i) * value_type(-1.25) + value_type(0.1);
+    }
+
+    std::vector<std::byte> bytes(values.size() * TestType::size());
+    pack_range<TestType>(bytes, 0, values);
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        REQUIRE(unpack<TestType>(bytes, i * TestType::size()) == values[i]);
+    }
+
+    std::vector<value_type> unpacked(values.size());
+    unpack_range<TestType>(bytes, 0, unpacked.begin(), unpacked.size());
+    REQUIRE(unpacked == values);
+}
+
+namespace {
+
+enum class record_kind : uint8_t
+{
+    a = 1,
+    b = 2,
+};
+
+struct record
+{
+    uint32_t id{0};
+    int16_t delta{0};
+    record_kind kind{record_kind::a};
+};
+
+} // namespace
+
+SCENARIO("Struct packing", "[packing][struct]")
+{
+    GIVEN("a sequence of bytes")
+    {
+        std::vector<std::byte> bytes{0x02_b, 0xff_b, 0xfe_b, 0x78_b, 0x56_b, 0x34_b, 0x12_b};
+
+        WHEN("unpacking with struct_packing")
+        {
+            using packing =
+                struct_packing<record, field<&record::kind, raw<uint8_t>>,
+                               field<&record::delta, int16_be>, field<&record::id, uint32_le>>;
+            static_assert(packing::size() == 7);
+            auto const value = unpack<packing>(bytes, 0);
+
+            THEN("the members are correct")
+            {
+                REQUIRE(value.kind == record_kind::b);
+                REQUIRE(value.delta == -2);
+                REQUIRE(value.id == 0x12345678);
+            }
+            THEN("packing restores the bytes")
+            {
+                std::vector<std::byte> packed(bytes.size());
+                pack<packing>(packed, 0, value);
+                REQUIRE(packed == bytes);
+            }
+        }
+        WHEN("unpacking into existing variables")
+        {
+            uint8_t first{0};
+            int32_t second{0};
+            record_kind third{record_kind::a};
+            unpack_into<raw<uint8_t>, int16_be, raw<uint8_t>>(bytes, 1, first, second, third);
+
+            THEN("the variables are correct")
+            {
+                REQUIRE(first == 0xff);
+                REQUIRE(second == -392);
+                REQUIRE(third == static_cast<record_kind>(0x56));
+            }
+        }
+    }
+    GIVEN("an aggregate_packing matching the declaration order")
+    {
+        using packing = aggregate_packing<record, uint32_le, int16_be, raw<uint8_t>>;
+        std::vector<std::byte> bytes{0x78_b, 0x56_b, 0x34_b, 0x12_b, 0xff_b, 0xfe_b, 0x02_b};
+
+        WHEN("unpacking a value")
+        {
+            auto const value = unpack<packing>(bytes, 0);
+
+            THEN("the members are correct")
+            {
+                REQUIRE(value.id == 0x12345678);
+                REQUIRE(value.delta == -2);
+                REQUIRE(value.kind == record_kind::b);
+            }
+            THEN("packing restores the bytes")
+            {
+                std::vector<std::byte> packed(bytes.size());
+                pack<packing>(packed, 0, value);
+                REQUIRE(packed == bytes);
+            }
+        }
+    }
+}
+
+namespace {
+
+enum class color : uint16_t
+{
+    red = 1,
+    green = 2,
+    blue = 4,
+};
+
+struct meters
+{
+    uint32_t value;
+
+    auto operator==(const meters&) const -> bool = default;
+};
+
+} // namespace
+
+SCENARIO("Typed packings", "[packing][typed]")
+{
+    using color_le = enum_packing<color, uint16_le, color::red, color::green, color::blue>;
+
+    GIVEN("a sequence of bytes")
+    {
+        std::vector<std::byte> bytes{0x02_b, 0x00_b, 0x03_b, 0x00_b, 0x01_b, 0x00_b, 0x00_b,
+                                     0x00_b, 0x2a_b, 0x00_b, 0x00_b, 0x00_b};
+
+        THEN("values are unpacked as their types")
+        {
+            REQUIRE(unpack<color_le>(bytes, 0) == color::green);
+            REQUIRE(unpack<bool_packing<>>(bytes, 2));
+            REQUIRE_FALSE(unpack<bool_packing<uint16_le>>(bytes, 6));
+            REQUIRE(unpack<as<meters, uint32_le>>(bytes, 8) == meters{42});
+            REQUIRE(unpack<as<uint64_t, uint32_le>>(bytes, 8) == 42);
+        }
+        THEN("tuples of typed packings are unpacked like the untyped packings")
+        {
+            using packing = tuple_packing<color_le, as<uint16_t, uint16_le>, uint32_le,
+                                          as<meters, uint32_le>>;
+            REQUIRE(unpack<packing>(bytes, 0) ==
+                    std::tuple<color, uint16_t, uint32_t, meters>{color::green, 3, 1, meters{42}});
+            REQUIRE(packing::is_valid(unpack<packing>(bytes, 0)));
+        }
+        THEN("the checked unpacking functions reject unknown enumerators")
+        {
+            REQUIRE(try_unpack<color_le>(bytes, 0) == color::green);
+            REQUIRE(try_unpack<color_le>(bytes, 2) ==
+                    std::unexpected{unpack_error::invalid_value});
+            REQUIRE(try_unpack<color_le>(bytes, 6) ==
+                    std::unexpected{unpack_error::invalid_value});
+            REQUIRE(try_unpack_tuple<color_le, color_le>(bytes, 2) ==
+                    std::unexpected{unpack_error::invalid_value});
+            REQUIRE(try_unpack<enum_packing<color, uint16_le>>(bytes, 2) ==
+                    static_cast<color>(3));
+
+            std::vector<color> values(3, color::red);
+            REQUIRE(try_unpack_range<color_le>(bytes, 0, values.begin(), 3) ==
+                    std::unexpected{unpack_error::invalid_value});
+            REQUIRE(values == std::vector<color>{color::green, color::red, color::red});
+        }
+    }
+    GIVEN("typed values")
+    {
+        std::vector<std::byte> bytes(9);
+
+        THEN("packing writes the packed values")
+        {
+            pack<color_le>(bytes, 0, color::blue);
+            pack<bool_packing<>>(bytes, 2, true);
+            pack<as<meters, uint32_be>>(bytes, 3, meters{0x01020304});
+            pack<bool_packing<uint16_le>>(bytes, 7, false);
+            REQUIRE(bytes == std::vector<std::byte>{0x04_b, 0x00_b, 0x01_b, 0x01_b, 0x02_b, 0x03_b,
+                                                    0x04_b, 0x00_b, 0x00_b});
+        }
+    }
+    GIVEN("an enumeration with far apart values")
+    {
+        enum class sparse : int32_t
+        {
+            low = -100000,
+            high = 100000,
+        };
+        using packing = enum_packing<sparse, int32_be, sparse::low, sparse::high>;
+
+        THEN("only the given values are valid")
+        {
+            REQUIRE(packing::is_valid(sparse::low));
+            REQUIRE(packing::is_valid(sparse::high));
+            REQUIRE_FALSE(packing::is_valid(static_cast<sparse>(0)));
+        }
+    }
+    GIVEN("an enumeration with a signed underlying type")
+    {
+        enum class level : int32_t
+        {
+            five = 5,
+            six = 6,
+        };
+        using packing = enum_packing<level, int32_le, level::five, level::six>;
+
+        THEN("values below the lowest one are invalid")
+        {
+            REQUIRE(packing::is_valid(level::six));
+            REQUIRE_FALSE(packing::is_valid(static_cast<level>(4)));
+            REQUIRE_FALSE(packing::is_valid(static_cast<level>(-1)));
+            using limits = std::numeric_limits<int32_t>;
+            REQUIRE_FALSE(packing::is_valid(static_cast<level>(limits::min())));
+            REQUIRE_FALSE(packing::is_valid(static_cast<level>(limits::max())));
+        }
+        THEN("checked unpacking rejects the minimum of the underlying type")
+        {
+            auto const bytes = std::array{0x00_b, 0x00_b, 0x00_b, 0x80_b};
+            REQUIRE(try_unpack<packing>(bytes, 0) == std::unexpected{unpack_error::invalid_value});
+        }
+    }
+    GIVEN("a struct with a validated member")
+    {
+        using packing = aggregate_packing<record, uint32_le, int16_be,
+                                          enum_packing<record_kind, raw<uint8_t>, record_kind::a,
+                                                       record_kind::b>>;
+
+        THEN("the members are validated")
+        {
+            REQUIRE(packing::is_valid(record{1, 2, record_kind::b}));
+            REQUIRE_FALSE(packing::is_valid(record{1, 2, static_cast<record_kind>(3)}));
+        }
+    }
+}
+
+SCENARIO("Variant packing", "[packing][variant]")
+{
+    enum class event : uint8_t
+    {
+        key = 1,
+        move = 2,
+        text = 7,
+    };
+    using packing = variant_packing<enum_packing<event, raw<uint8_t>>,
+                                    alternative<event::key, uint16_le>,
+                                    alternative<event::move, tuple_packing<int16_le, int16_le>>,
+                                    alternative<event::text, length_prefixed<raw<uint8_t>>>>;
+    static_assert(variable_byte_packing<packing>);
+
+    GIVEN("a sequence of tagged payloads")
+    {
+        std::vector<std::byte> bytes{0x02_b, 0xff_b, 0xff_b, 0x05_b, 0x00_b, 0x07_b, 0x02_b,
+                                     0x68_b, 0x69_b, 0x01_b, 0x34_b, 0x12_b, 0x03_b};
+
+        WHEN("unpacking them")
+        {
+            std::size_t offset = 0, size;
+            auto const move = packing::unpack(bytes.data(), size);
+            offset += size;
+            REQUIRE(size == 5);
+            auto const text = packing::unpack(bytes.data() + offset, size);
+            offset += size;
+            REQUIRE(size == 4);
+            auto const key = packing::unpack(bytes.data() + offset, size);
+            REQUIRE(size == 3);
+
+            THEN("the variants hold the payloads")
+            {
+                REQUIRE(std::get<1>(move) == std::tuple<int16_t, int16_t>{-1, 5});
+                REQUIRE(as_string_view(std::get<2>(text)) == "hi");
+                REQUIRE(std::get<0>(key) == 0x1234);
+            }
+            THEN("packing restores the bytes")
+            {
+                std::vector<std::byte> packed(packing::size(move) + packing::size(text) +
+                                              packing::size(key));
+                REQUIRE(packed.size() == 12);
+                auto position = packing::pack(packed.data(), move);
+                position += packing::pack(packed.data() + position, text);
+                position += packing::pack(packed.data() + position, key);
+                REQUIRE(position == 12);
+                REQUIRE(std::ranges::equal(packed, byte_span{bytes}.first(12)));
+            }
+        }
+        THEN("unknown tags are rejected")
+        {
+            std::size_t size;
+            REQUIRE_THROWS_AS(packing::unpack(bytes.data() + 12, size), std::invalid_argument);
+            REQUIRE(packing::find(event::text) == 2);
+            REQUIRE(packing::find(static_cast<event>(0)) == packing::npos);
+            REQUIRE(packing::find(static_cast<event>(3)) == packing::npos);
+            REQUIRE(packing::find(static_cast<event>(200)) == packing::npos);
+        }
+        THEN("checked unpacking reports unknown tags and truncated payloads")
+        {
+            std::size_t size = 0;
+            auto const move = try_unpack<packing>(bytes, 0, size);
+            REQUIRE(std::get<1>(*move) == std::tuple<int16_t, int16_t>{-1, 5});
+            REQUIRE(size == 5);
+            REQUIRE(try_unpack<packing>(bytes, 12, size).error() == unpack_error::invalid_value);
+            REQUIRE(try_unpack<packing>(byte_span{bytes}.first(4), 0, size).error() ==
+                    unpack_error::out_of_bounds);
+            // The text "hi" ends after 9 bytes.
+            REQUIRE(try_unpack<packing>(byte_span{bytes}.first(8), 5, size).error() ==
+                    unpack_error::out_of_bounds);
+            REQUIRE(try_unpack<packing>(bytes, 13, size).error() == unpack_error::out_of_bounds);
+        }
+        THEN("checked visiting calls the visitor only for valid payloads")
+        {
+            std::size_t size = 0;
+            int calls = 0;
+            auto const index_of = [&](auto&&, auto index) {
+                ++calls;
+                return decltype(index)::value;
+            };
+            REQUIRE(packing::try_visit(bytes.data() + 5, 8, size, index_of) == 2);
+            REQUIRE(size == 4);
+            REQUIRE(packing::try_visit(bytes.data() + 9, 2, size, index_of).error() ==
+                    unpack_error::out_of_bounds);
+            REQUIRE(packing::try_visit(bytes.data() + 12, 1, size, index_of).error() ==
+                    unpack_error::invalid_value);
+            REQUIRE(calls == 1);
+            REQUIRE(packing::try_visit(bytes.data() + 9, 3, size, [](auto&&) {}).has_value());
+            REQUIRE(size == 3);
+        }
+    }
+    GIVEN("tags that are far apart")
+    {
+        using sparse = variant_packing<int32_be, alternative<-70000, raw<uint8_t>>,
+                                       alternative<70000, raw<uint8_t>>>;
+
+        THEN("the tags are found")
+        {
+            REQUIRE(sparse::find(-70000) == 0);
+            REQUIRE(sparse::find(70000) == 1);
+            REQUIRE(sparse::find(0) == sparse::npos);
+        }
+        THEN("checked unpacking rejects unknown tags")
+        {
+            std::vector<std::byte> const bytes{0x00_b, 0x01_b, 0x11_b, 0x70_b, 0x2a_b};
+            std::size_t size = 0;
+            REQUIRE(try_unpack<sparse>(bytes, 0, size)->index() == 1);
+            REQUIRE(size == 5);
+            REQUIRE(try_unpack<sparse>(byte_span{bytes}.first(4), 0, size).error() ==
+                    unpack_error::out_of_bounds);
+            REQUIRE(try_unpack<sparse>(std::vector<std::byte>(5), 0, size).error() ==
+                    unpack_error::invalid_value);
+        }
+    }
+}
@@ -0,0 +1,151 @@
+#include <catch2/catch_all.hpp>
+#include <dualis.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace dualis;
+
+namespace {
+
+// A packing that throws when unpacking a marked value, to check that errors reach the caller.
+struct throwing_packing
+{
+    using value_type = uint8_t;
+
+    [[nodiscard]] static auto unpack(const std::byte* bytes) -> uint8_t
+    {
+        if (*bytes == std::byte{0xff})
+        {
+            throw std::invalid_argument{"marked value"};
+        }
+        return std::to_integer<uint8_t>(*bytes);
+    }
+
+    static void pack(std::byte* bytes, uint8_t value)
+    {
+        *bytes = std::byte{value};
+    }
+
+    [[nodiscard]] static constexpr auto size() -> std::size_t
+    {
+        return 1;
+    }
+};
+
+} // namespace
+
+SCENARIO("Parallel unpacking and packing of ranges", "[parallel]")
+{
+    auto const policy = GENERATE(parallel_policy{4, 64, 0}, parallel_policy{3, 100, 256},
+                                 parallel_policy{1, 64, 0}, parallel_policy{8, 1, 0});
+
+    GIVEN("an array of big endian integers")
+    {
+        auto const count = GENERATE(std::size_t{0}, 1, 31, 1000, 4099);
+        std::vector<std::byte> bytes(3 + count * 4);
+        for (std::size_t i = 0; i < bytes.size(); ++i)
+        {
+            bytes[i] = static_cast<std::byte>(i * 131 + 7);
+        }
+
+        THEN("the values are the same as when unpacked serially")
+        {
+            std::vector<uint32_t> expected(count), values(count);
+            unpack_range<uint32_be>(bytes, 3, expected.begin(), count);
+            auto const last = unpack_range<uint32_be>(policy, bytes, 3, values.begin(), count);
+            REQUIRE(last == values.end());
+            REQUIRE(values == expected);
+        }
+        THEN("the values are packed into the same bytes")
+        {
+            std::vector<uint32_t> values(count);
+            unpack_range<uint32_be>(bytes, 3, values.begin(), count);
+            std::vector<std::byte> packed(bytes.size());
+            std::copy_n(bytes.begin(), 3, packed.begin());
+            pack_range<uint32_be>(policy, packed, 3, values);
+            REQUIRE(packed == bytes);
+
+            std::ranges::fill(packed, std::byte{0});
+            std::copy_n(bytes.begin(), 3, packed.begin());
+            pack_range<tuple_packing<uint32_be>>(policy, packed, 3, values.begin(), values.end());
+            REQUIRE(packed == bytes);
+        }
+    }
+    GIVEN("a packing that throws")
+    {
+        std::vector<std::byte> bytes(1000, std::byte{1});
+        bytes[700] = std::byte{0xff};
+
+        THEN("the exception is rethrown")
+        {
+            std::vector<uint8_t> values(bytes.size());
+            REQUIRE_THROWS_AS(
+                unpack_range<throwing_packing>(policy, bytes, 0, values.begin(), bytes.size()),
+                std::invalid_argument);
+        }
+    }
+}
+
+SCENARIO("Parallel packing of variable-size values", "[parallel][varint]")
+{
+    auto const policy = GENERATE(parallel_policy{4, 64, 0}, parallel_policy{3, 1000, 4096},
+                                 parallel_policy{1, 64, 0}, parallel_policy{8, 1, 0});
+
+    GIVEN("integers of varying lengths")
+    {
+        auto const count = GENERATE(std::size_t{0}, 1, 100, 5000);
+        std::vector<uint64_t> values(count);
+        uint64_t state = 0x9e3779b97f4a7c15;
+        for (auto& value : values)
+        {
+            state = state * 6364136223846793005 + 1442695040888963407;
+            value = state >> (state % 64);
+        }
+
+        THEN("they are appended as if packed one after another")
+        {
+            byte_string expected{std::byte{0xaa}};
+            for (auto const value : values)
+            {
+                expected.append_packed<leb128<uint64_t>>(value);
+            }
+
+            byte_string bytes{std::byte{0xaa}};
+            auto const size = append_varint_range<leb128<uint64_t>>(policy, bytes, values);
+            REQUIRE(size == expected.size() - 1);
+            REQUIRE(bytes == expected);
+
+            std::vector<std::byte> serial{std::byte{0xaa}};
+            REQUIRE(append_varint_range<leb128<uint64_t>>(serial, values) == size);
+            REQUIRE(std::ranges::equal(serial, expected));
+        }
+    }
+    GIVEN("strings")
+    {
+        std::vector<std::string> strings;
+        for (std::size_t i = 0; i < 300; ++i)
+        {
+            strings.emplace_back(i % 150, static_cast<char>('a' + i % 26));
+        }
+        std::vector<byte_span> spans;
+        for (auto const& string : strings)
+        {
+            spans.push_back(as_bytes(std::span{string}));
+        }
+
+        THEN("they are appended with their lengths")
+        {
+            byte_vector bytes;
+            append_varint_range<length_prefixed<leb128<uint32_t>>>(policy, bytes, spans);
+            std::size_t offset = 0;
+            for (auto const& string : strings)
+            {
+                auto const span = unpack<length_prefixed<leb128<uint32_t>>>(bytes, offset);
+                REQUIRE(as_string_view(span) == string);
+                offset += length_prefixed<leb128<uint32_t>>::size(span);
+            }
+            REQUIRE(offset == bytes.size());
+        }
+    }
+}
@@ -0,0 +1,168 @@
+#include <catch2/catch_all.hpp>
+#include <dualis.h>
+#include <string>
+#include <vector>
+
+using namespace dualis;
+
+namespace {
+
+auto make_test_bytes(std::size_t size) -> std::vector<std::byte>
+{
+    std::vector<std::byte> bytes(size);
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        bytes[i] = static_cast<std::byte>(i * 31 + 7);
+    }
+    return bytes;
+}
+
+auto supported_levels() -> std::vector<simd_level>
+{
+    std::vector<simd_level> levels;
+    for (auto level = simd_level::scalar; level <= detect_simd_level();
+         level = static_cast<simd_level>(static_cast<int>(level) + 1))
+    {
+        levels.push_back(level);
+    }
+    return levels;
+}
+
+} // namespace
+
+SCENARIO("Selecting the simd level", "[simd]")
+{
+    THEN("the active level is supported by the CPU")
+    {
+        REQUIRE(active_simd_level() <= detect_simd_level());
+        REQUIRE_FALSE(simd_level_name(active_simd_level()).empty());
+    }
+}
+
+TEMPLATE_TEST_CASE_SIG("Byte swapping kernels", "[simd]", ((std::size_t Width), Width), 2, 4, 8)
+{
+    for (auto const level : supported_levels())
+    {
+        auto const kernels = detail::_make_simd_kernels(level);
+        for (std::size_t count : {0, 1, 7, 8, 31, 64, 133})
+        {
+            auto const src = make_test_bytes(count * Width);
+            std::vector<std::byte> dest(src.size());
+            kernels.template copy_swapped<Width>()(dest.data(), src.data(), count);
+
+            INFO("level " << simd_level_name(level) << ", count " << count);
+            for (std::size_t i = 0; i < src.size(); ++i)
+            {
+                REQUIRE(dest[i] == src[i / Width * Width + Width - 1 - i % Width]);
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE_SIG("24-bit widening kernels", "[simd]",
+                       ((std::endian Order, bool Signed), Order, Signed),
+                       (std::endian::little, false), (std::endian::little, true),
+                       (std::endian::big, false), (std::endian::big, true))
+{
+    for (auto const level : supported_levels())
+    {
+        auto const kernels = detail::_make_simd_kernels(level);
+        for (std::size_t count : {0, 1, 5, 6, 9, 10, 64, 133})
+        {
+            auto const src = make_test_bytes(count * 3);
+            std::vector<uint32_t> expected(count), actual(count);
+            detail::_widen_24_scalar<Order, Signed>(expected.data(), src.data(), count);
+            kernels.template widen_24<Order, Signed>()(actual.data(), src.data(), count);
+
+            INFO("level " << simd_level_name(level) << ", count " << count);
+            REQUIRE(actual == expected);
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE_SIG("Strided gathering kernels", "[simd]", ((std::size_t Width), Width), 4, 8)
+{
+    for (auto const level : supported_levels())
+    {
+        auto const kernels = detail::_make_simd_kernels(level);
+        auto const gather = Width == 4 ? kernels.gather_strided_4 : kernels.gather_strided_8;
+        for (std::size_t stride : {Width, Width + 3, std::size_t{64}})
+        {
+            for (std::size_t count : {0, 1, 7, 8, 19})
+            {
+                auto const src = make_test_bytes(count * stride + Width);
+                std::vector<std::byte> expected(count * Width), actual(count * Width);
+                detail::_gather_strided_scalar<Width>(expected.data(), src.data(), stride, count);
+                gather(actual.data(), src.data(), stride, count);
+
+                INFO("level " << simd_level_name(level) << ", stride " << stride << ", count "
+                              << count);
+                REQUIRE(actual == expected);
+            }
+        }
+    }
+}
+
+SCENARIO("Byte search kernels", "[simd]")
+{
+    for (auto const level : supported_levels())
+    {
+        auto const kernels = detail::_make_simd_kernels(level);
+        for (std::size_t size : {0, 1, 15, 16, 33, 64, 100, 200})
+        {
+            std::vector<std::byte> bytes(size, std::byte{1});
+            INFO("level " << simd_level_name(level) << ", size " << size);
+            REQUIRE(kernels.find_byte(bytes.data(), size, std::byte{0}) == size);
+            for (std::size_t position = 0; position < size; ++position)
+            {
+                bytes[position] = std::byte{0};
+                if (position + 1 < size)
+                {
+                    bytes[position + 1] = std::byte{0};
+                }
+                REQUIRE(kernels.find_byte(bytes.data(), size, std::byte{0}) == position);
+                bytes[position] = std::byte{1};
+                if (position + 1 < size)
+                {
+                    bytes[position + 1] = std::byte{1};
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("Base64 encoding", "[simd][base64]")
+{
+    GIVEN("well-known test vectors")
+    {
+        using namespace dualis::literals;
+        REQUIRE(to_base64(""_bspan) == "");
+        REQUIRE(to_base64("f"_bspan) == "Zg==");
+        REQUIRE(to_base64("fo"_bspan) == "Zm8=");
+        REQUIRE(to_base64("foo"_bspan) == "Zm9v");
+        REQUIRE(to_base64("foobar"_bspan) == "Zm9vYmFy");
+        REQUIRE(to_base64("Many hands make light work. Many hands make light work."_bspan) ==
+                "TWFueSBoYW5kcyBtYWtlIGxpZ2h0IHdvcmsuIE1hbnkgaGFuZHMgbWFrZSBsaWdodCB3b3JrLg==");
+    }
+    GIVEN("bytes covering all digits")
+    {
+        auto const bytes = make_test_bytes(300);
+        for (auto const level : supported_levels())
+        {
+            auto const kernels = detail::_make_simd_kernels(level);
+            std::string expected(400, ' '), actual(400, ' ');
+            auto const* data = reinterpret_cast<const uint8_t*>(bytes.data());
+            REQUIRE(detail::_encode_base64_scalar(expected.data(), data, bytes.size()) == 300);
+            REQUIRE(kernels.encode_base64(actual.data(), data, bytes.size()) == 300);
+
+            INFO("level " << simd_level_name(level));
+            REQUIRE(actual == expected);
+        }
+        THEN("decoding restores the bytes")
+        {
+            auto const decoded = from_base64<byte_vector>(to_base64(bytes));
+            REQUIRE(decoded.has_value());
+            REQUIRE(std::equal(bytes.begin(), bytes.end(), decoded->begin(), decoded->end()));
+        }
+    }
+}
@@ -0,0 +1,313 @@
+#include <catch2/catch_all.hpp>
+#include <dualis.h>
+#include <vector>
+
+using namespace dualis;
+using namespace dualis::literals;
+
+namespace {
+
+// Reads single bits the slow way to compare bit_stream against.
+auto naive_read_bits(const std::vector<std::byte>& bytes, std::size_t position, unsigned count,
+                     bit_order order) -> uint64_t
+{
+    uint64_t value = 0;
+    for (unsigned i = 0; i < count; ++i, ++position)
+    {
+        auto const byte =
+            position / 8 < bytes.size() ? std::to_integer<unsigned>(bytes[position / 8]) : 0u;
+        auto const shift = order == bit_order::msb_first ? 7 - position % 8 : position % 8;
+        uint64_t const bit = (byte >> shift) & 1;
+        value = order == bit_order::msb_first ? (value << 1) | bit : value | (bit << i);
+    }
+    return value;
+}
+
+} // namespace
+
+SCENARIO("Reading terminated strings", "[streams][strings]")
+{
+    GIVEN("a table of strings")
+    {
+        using namespace dualis::literals;
+        auto const bytes = "first\0\0third\xffrest"_bspan;
+
+        THEN("unpack_cstring returns views of the strings")
+        {
+            REQUIRE(unpack_cstring(bytes, 0) == "first");
+            REQUIRE(unpack_cstring(bytes, 0).data() == reinterpret_cast<const char*>(bytes.data()));
+            REQUIRE(unpack_cstring(bytes, 6).empty());
+            REQUIRE(unpack_cstring(bytes, 7, std::byte{0xff}) == "third");
+            REQUIRE(unpack_cstring(bytes, 13) == "rest");
+            REQUIRE(find_terminator(bytes, 13) == bytes.size());
+            REQUIRE(unpack_cstring(bytes, bytes.size()).empty());
+            REQUIRE(unpack_cstring(bytes, bytes.size() + 1).empty());
+        }
+        THEN("read_cstring skips the terminators")
+        {
+            byte_stream stream{bytes};
+            REQUIRE(stream.read_cstring() == "first");
+            REQUIRE(stream.read_cstring().empty());
+            REQUIRE(stream.read_cstring(std::byte{0xff}) == "third");
+            REQUIRE(stream.tellg() == 13);
+            REQUIRE(stream.read_cstring() == "rest");
+            REQUIRE(stream.tellg() == bytes.size());
+            REQUIRE(stream.read_cstring().empty());
+            REQUIRE(stream.tellg() == bytes.size());
+            stream.seekg(bytes.size() + 5);
+            REQUIRE(stream.read_cstring().empty());
+            REQUIRE(stream.tellg() == bytes.size() + 5);
+        }
+    }
+}
+
+SCENARIO("Skipping padding", "[streams][pseudo]")
+{
+    GIVEN("a stream of padded records")
+    {
+        std::vector<std::byte> const bytes{0x01_b, 0x00_b, 0x00_b, 0x00_b, 0x02_b, 0x00_b,
+                                           0x03_b, 0x00_b, 0x00_b, 0x00_b, 0x04_b, 0x00_b};
+        byte_stream stream{bytes};
+
+        THEN("pseudo packings advance the stream")
+        {
+            REQUIRE(stream.unpack<raw<uint8_t>>() == 1);
+            stream.advance<align<4>>();
+            REQUIRE(stream.tellg() == 4);
+            stream.advance<align<4>>();
+            REQUIRE(stream.tellg() == 4);
+            REQUIRE(stream.unpack_tuple<uint16_le, skip<1>, raw<uint8_t>>() == std::tuple{2, 0});
+            REQUIRE(stream.tellg() == 8);
+            stream.advance<pad<2>>();
+            REQUIRE(stream.unpack<uint16_le>() == 4);
+            REQUIRE(stream.tellg() == bytes.size());
+        }
+        THEN("signature packings advance the stream only if they match")
+        {
+            REQUIRE_FALSE(stream.advance_if_matches<expect<uint16_le, 2>>());
+            REQUIRE(stream.tellg() == 0);
+            REQUIRE(stream.advance_if_matches<expect<uint16_le, 1>>());
+            REQUIRE(stream.tellg() == 2);
+            REQUIRE(stream.advance_if_matches<tuple_packing<skip<2>, expect<raw<uint8_t>, 2>>>());
+            REQUIRE(stream.tellg() == 5);
+            stream.seekg(11);
+            REQUIRE_FALSE(stream.advance_if_matches<expect<uint16_le, 0>>());
+            REQUIRE(stream.tellg() == 11);
+        }
+    }
+}
+
+SCENARIO("Visiting tagged unions", "[streams][variant]")
+{
+    using packing = variant_packing<raw<uint8_t>, alternative<0, uint16_be>,
+                                    alternative<1, uint32_be>, alternative<2, uint16_be>>;
+
+    GIVEN("a stream of tagged payloads")
+    {
+        std::vector<std::byte> bytes{0x01_b, 0x00_b, 0x00_b, 0x01_b, 0x00_b, 0x02_b,
+                                     0x00_b, 0x03_b, 0x00_b, 0x00_b, 0x04_b};
+        byte_stream stream{bytes};
+
+        THEN("each payload is passed to the visitor")
+        {
+            std::vector<uint64_t> values;
+            while (stream.tellg() < bytes.size())
+            {
+                stream.visit_next<packing>([&](auto value) { values.push_back(value); });
+            }
+            REQUIRE(values == std::vector<uint64_t>{0x100, 3, 4});
+            REQUIRE(stream.tellg() == bytes.size());
+        }
+        THEN("the visitor can tell apart alternatives of the same type")
+        {
+            stream.seekg(5);
+            auto const index = stream.visit_next<packing>(
+                [](auto, auto index) { return static_cast<std::size_t>(index); });
+            REQUIRE(index == 2);
+            REQUIRE(stream.tellg() == 8);
+        }
+        THEN("the visitor can continue reading the stream")
+        {
+            auto const next = stream.visit_next<packing>(
+                [&](auto) { return stream.unpack<raw<uint8_t>>(); });
+            REQUIRE(next == 0x02);
+        }
+    }
+}
+
+SCENARIO("Reading bits", "[streams][bits]")
+{
+    GIVEN("a sequence of bytes")
+    {
+        std::vector<std::byte> bytes{0b1011'0010_b, 0b0111'1100_b, 0xff_b, 0x01_b};
+
+        WHEN("reading MSB first")
+        {
+            bit_stream<bit_order::msb_first> bits{bytes};
+
+            THEN("the values are correct")
+            {
+                REQUIRE(bits.read_bits(3) == 0b101);
+                REQUIRE(bits.peek_bits(5) == 0b10010);
+                REQUIRE(bits.read_bits(5) == 0b10010);
+                REQUIRE(bits.read_bit() == false);
+                REQUIRE(bits.read_bits(0) == 0);
+                REQUIRE(bits.tell_bits() == 9);
+            }
+            THEN("aligning skips to the next byte")
+            {
+                bits.skip_bits(9);
+                bits.align_to_byte();
+                REQUIRE(bits.tell_bits() == 16);
+                REQUIRE(bits.tellg() == 2);
+                REQUIRE(bits.read_bits(8) == 0xff);
+            }
+            THEN("reading past the end yields zero bits")
+            {
+                bits.skip_bits(28);
+                REQUIRE(bits.read_bits(12) == 0b0001'0000'0000);
+            }
+        }
+        WHEN("reading LSB first")
+        {
+            bit_stream<bit_order::lsb_first> bits{bytes};
+
+            THEN("the values are correct")
+            {
+                REQUIRE(bits.read_bits(3) == 0b010);
+                REQUIRE(bits.read_bits(7) == 0b00'10110);
+                REQUIRE(bits.read_bits(16) == 0b01'1111'1111'0111'11);
+            }
+        }
+        WHEN("continuing from a byte_stream")
+        {
+            byte_stream stream{bytes};
+            stream.seekg(1);
+            bit_stream bits{stream};
+            REQUIRE(bits.read_bits(4) == 0b0111);
+            bits.align_to_byte();
+            stream.seekg(bits.tellg());
+
+            THEN("the byte_stream continues after the bits")
+            {
+                REQUIRE(stream.unpack<uint16_le>() == 0x01ff);
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE_SIG("Reading bits of varying widths", "[streams][bits]",
+                       ((bit_order Order), Order), bit_order::msb_first, bit_order::lsb_first)
+{
+    std::vector<std::byte> bytes(67);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::byte>(i * 73 + 11);
+    }
+
+    bit_stream<Order> bits{bytes};
+    std::size_t position = 0;
+    for (unsigned count = 0; position < bytes.size() * 8; count = (count + 5) % 57)
+    {
+        INFO("position " << position << ", count " << count);
+        REQUIRE(bits.read_bits(count) == naive_read_bits(bytes, position, count, Order));
+        position += count;
+        REQUIRE(bits.tell_bits() == position);
+    }
+
+    bits.seek_bits(3);
+    bits.skip_bits(200);
+    REQUIRE(bits.read_bits(9) == naive_read_bits(bytes, 203, 9, Order));
+}
+
+SCENARIO("Writing bits", "[streams][bits]")
+{
+    GIVEN("an empty byte_vector")
+    {
+        byte_vector bytes;
+
+        WHEN("writing MSB first")
+        {
+            bit_writer<bit_order::msb_first> writer{bytes};
+            writer.write_bits(0b101, 3);
+            writer.write_bits(0b10010, 5);
+            writer.write_bit(false);
+            writer.write_bits(0xfff, 4);
+            writer.flush();
+
+            THEN("the bytes are correct")
+            {
+                REQUIRE(bytes == byte_vector{0b1011'0010_b, 0b0111'1000_b});
+            }
+        }
+        WHEN("writing LSB first")
+        {
+            bit_writer<bit_order::lsb_first> writer{bytes};
+            writer.write_bits(0b010, 3);
+            writer.write_bits(0b00'10110, 7);
+            writer.write_bits(0b11'1111, 6);
+            writer.flush();
+
+            THEN("the bytes are correct")
+            {
+                REQUIRE(bytes == byte_vector{0b1011'0010_b, 0b1111'1100_b});
+            }
+        }
+    }
+}
+
+TEMPLATE_TEST_CASE_SIG("Writing and reading bits of varying widths", "[streams][bits]",
+                       ((bit_order Order), Order), bit_order::msb_first, bit_order::lsb_first)
+{
+    byte_string bytes{0xaa_b};
+    std::vector<std::pair<uint64_t, unsigned>> values;
+    {
+        bit_writer<Order, byte_string> writer{bytes, 4096};
+        uint64_t value = 0x9e3779b97f4a7c15;
+        for (unsigned i = 0; i < 300; ++i)
+        {
+            auto const count = (i * 7) % 65;
+            value = value * 6364136223846793005 + 1442695040888963407;
+            writer.write_bits(value, count);
+            values.emplace_back(count < 64 ? value & ((uint64_t{1} << count) - 1) : value, count);
+        }
+        REQUIRE(writer.tell_bits() % 8 != 0);
+        writer.flush();
+        REQUIRE(writer.tell_bits() % 8 == 0);
+    }
+
+    bit_stream<Order> bits{bytes, 1};
+    for (auto const& [value, count] : values)
+    {
+        // Values wider than max_bits are read in two steps.
+        auto const high_count = count > bit_stream<Order>::max_bits ? count - 32 : 0;
+        auto const low_count = count - high_count;
+        auto const first = bits.read_bits(Order == bit_order::msb_first ? high_count : low_count);
+        auto const second = bits.read_bits(Order == bit_order::msb_first ? low_count : high_count);
+        auto const read = Order == bit_order::msb_first ? (first << low_count) | second
+                                                        : first | (second << low_count);
+        REQUIRE(read == value);
+    }
+}
+
+TEMPLATE_TEST_CASE_SIG("Aligning a full bit register", "[streams][bits]",
+                       ((bit_order Order), Order), bit_order::msb_first, bit_order::lsb_first)
+{
+    for (unsigned count = 57; count < 64; ++count)
+    {
+        INFO("count " << count);
+        byte_vector bytes;
+        bit_writer<Order> writer{bytes};
+        writer.write_bits(0, count);
+        writer.align_to_byte();
+        REQUIRE(writer.tell_bits() == 64);
+        writer.write_bit(true);
+        writer.write_bits(~uint64_t{0}, 64);
+        writer.flush();
+
+        byte_vector expected(8, 0x00_b);
+        expected.append(8, 0xff_b);
+        expected.append(1, Order == bit_order::msb_first ? 0x80_b : 0x01_b);
+        REQUIRE(bytes == expected);
+    }
+}
@@ -0,0 +1,229 @@
+#include <catch2/catch_all.hpp>
+#include <dualis.h>
+#include <numeric>
+#include <vector>
+
+using namespace dualis;
+using namespace dualis::literals;
+
+SCENARIO("Packed views", "[views]")
+{
+    GIVEN("a sequence of big endian integers")
+    {
+        std::vector<std::byte> bytes{0xff_b, 0x00_b, 0x01_b, 0x00_b, 0x02_b, 0x01_b, 0x00_b};
+        packed_view<uint16_be> const view{bytes, 1, 3};
+
+        THEN("the values are unpacked on access")
+        {
+            REQUIRE(view.size() == 3);
+            REQUIRE(view[0] == 1);
+            REQUIRE(view[1] == 2);
+            REQUIRE(view[2] == 0x100);
+            REQUIRE(std::vector<uint16_t>(view.begin(), view.end()) ==
+                    std::vector<uint16_t>{1, 2, 0x100});
+        }
+        THEN("the iterators are random access")
+        {
+            auto it = view.begin();
+            REQUIRE(view.end() - it == 3);
+            REQUIRE(*(it + 2) == 0x100);
+            REQUIRE(it[1] == 2);
+            REQUIRE(++it < view.end());
+            REQUIRE(*it-- == 2);
+            REQUIRE(it == view.begin());
+        }
+        THEN("a view of all bytes contains all complete values")
+        {
+            REQUIRE(packed_view<uint16_be>{bytes}.size() == 3);
+            REQUIRE(packed_view<uint16_be>{bytes}.front() == 0xff00);
+        }
+    }
+}
+
+SCENARIO("Length-prefixed packings", "[views][packing]")
+{
+    GIVEN("bytes with a fixed-size length")
+    {
+        std::vector<std::byte> bytes{0x03_b, 0x00_b, 0x61_b, 0x62_b, 0x63_b, 0x64_b};
+
+        WHEN("unpacking the bytes")
+        {
+            byte_stream stream{bytes};
+            auto const value = stream.unpack<length_prefixed<uint16_le>>();
+
+            THEN("the result refers to the packed bytes")
+            {
+                REQUIRE(value.data() == bytes.data() + 2);
+                REQUIRE(as_string_view(value) == "abc");
+                REQUIRE(stream.tellg() == 5);
+            }
+            THEN("packing restores the bytes")
+            {
+                byte_vector packed;
+                packed.append_packed<length_prefixed<uint16_le>>(value);
+                REQUIRE(std::ranges::equal(packed, byte_span{bytes}.first(5)));
+            }
+        }
+        THEN("checked unpacking rejects lengths past the end")
+        {
+            using packing = length_prefixed<uint16_le>;
+            std::size_t size = 0;
+            REQUIRE(as_string_view(*try_unpack<packing>(bytes, 0, size)) == "abc");
+            REQUIRE(size == 5);
+            REQUIRE(try_unpack<packing>(byte_span{bytes}.first(4), 0, size).error() ==
+                    unpack_error::out_of_bounds);
+            REQUIRE(try_unpack<packing>(bytes, 5, size).error() == unpack_error::out_of_bounds);
+            REQUIRE(try_unpack<packing>(bytes, 7, size).error() == unpack_error::out_of_bounds);
+        }
+    }
+    GIVEN("bytes with a variable-size length")
+    {
+        std::vector<std::byte> bytes(131, 0x2a_b);
+        bytes[0] = 0x81_b;
+        bytes[1] = 0x01_b;
+
+        THEN("the length is unpacked first")
+        {
+            std::size_t size;
+            auto const value = length_prefixed<leb128<uint32_t>>::unpack(bytes.data(), size);
+            REQUIRE(value.size() == 129);
+            REQUIRE(size == 131);
+            REQUIRE(length_prefixed<leb128<uint32_t>>::size(value) == 131);
+        }
+    }
+    GIVEN("a counted array")
+    {
+        using packing = counted_array<raw<uint8_t>, int16_le>;
+        std::vector<std::byte> bytes{0x02_b, 0xfe_b, 0xff_b, 0x05_b, 0x00_b, 0x7f_b};
+
+        WHEN("unpacking it from a stream")
+        {
+            byte_stream stream{bytes};
+            auto const values = stream.unpack<packing>();
+
+            THEN("the elements are unpacked on access")
+            {
+                REQUIRE(values.size() == 2);
+                REQUIRE(values[0] == -2);
+                REQUIRE(values[1] == 5);
+                REQUIRE(stream.tellg() == 5);
+            }
+            THEN("packing restores the bytes")
+            {
+                std::vector<std::byte> packed(packing::size(values));
+                REQUIRE(pack<packing>(packed, 0, values) == 5);
+                REQUIRE(std::ranges::equal(packed, byte_span{bytes}.first(5)));
+            }
+        }
+        THEN("checked unpacking rejects counts past the end")
+        {
+            std::size_t size = 0;
+            REQUIRE(try_unpack<packing>(bytes, 0, size)->size() == 2);
+            REQUIRE(size == 5);
+            REQUIRE(try_unpack<packing>(byte_span{bytes}.first(4), 0, size).error() ==
+                    unpack_error::out_of_bounds);
+            // A count of 0x7f needs 254 bytes.
+            REQUIRE(try_unpack<packing>(bytes, 5, size).error() == unpack_error::out_of_bounds);
+        }
+    }
+}
+
+SCENARIO("Standard algorithms on packed views", "[views]")
+{
+    GIVEN("a sorted table of big endian integers")
+    {
+        byte_vector bytes;
+        for (uint32_t i = 0; i < 100; ++i)
+        {
+            bytes.append_packed<uint32_be>(i * i);
+        }
+        packed_view<uint32_be> const view{bytes};
+
+        THEN("the table can be searched without unpacking it")
+        {
+            REQUIRE(*std::ranges::lower_bound(view, 50u) == 64);
+            REQUIRE(std::ranges::lower_bound(view, 50u) - view.begin() == 8);
+            REQUIRE(std::ranges::binary_search(view, 81u));
+            REQUIRE(std::ranges::find(view, 49u) == view.begin() + 7);
+            REQUIRE(std::accumulate(view.begin(), view.end(), uint64_t{0}) == 328350);
+        }
+        THEN("sub-views and streams view parts of the table")
+        {
+            auto const tail = view.subview(98);
+            REQUIRE(tail.size() == 2);
+            REQUIRE(tail[1] == 99 * 99);
+            REQUIRE(view.subview(3, 2).back() == 16);
+            REQUIRE(view.subview(100).empty());
+            REQUIRE(view.subview(101, 5).empty());
+
+            byte_stream stream{bytes};
+            stream.seekg(4);
+            auto const part = stream.unpack_view<uint32_be>(3);
+            REQUIRE(std::ranges::equal(part, std::vector<uint32_t>{1, 4, 9}));
+            REQUIRE(stream.tellg() == 16);
+        }
+        THEN("unpacking the whole view uses the bulk path")
+        {
+            std::vector<uint32_t> values(view.size());
+            REQUIRE(unpack_range(view, values.begin()) == values.end());
+            REQUIRE(std::ranges::equal(values, view));
+        }
+    }
+}
+
+SCENARIO("Writable packed views", "[views]")
+{
+    GIVEN("a table of big endian pointers")
+    {
+        byte_vector bytes;
+        bytes.append_packed<uint16_le>(0xaaaa);
+        for (uint32_t i = 0; i < 8; ++i)
+        {
+            bytes.append_packed<uint32_be>(i * 0x100);
+        }
+        writable_packed_view<uint32_be> const table{bytes, 2, 8};
+
+        WHEN("patching single entries")
+        {
+            table[1] += 0x200;
+            table[2] = 7;
+            table[3] |= 1;
+            table[7] -= 0x700;
+
+            THEN("only those entries change")
+            {
+                REQUIRE(unpack<uint32_be>(bytes, 2 + 4) == 0x300);
+                REQUIRE(unpack<uint32_be>(bytes, 2 + 8) == 7);
+                REQUIRE(unpack<uint32_be>(bytes, 2 + 12) == 0x301);
+                REQUIRE(unpack<uint32_be>(bytes, 2 + 16) == 0x400);
+                REQUIRE(unpack<uint32_be>(bytes, 2 + 28) == 0);
+                REQUIRE(unpack<uint16_le>(bytes, 0) == 0xaaaa);
+            }
+        }
+        WHEN("using standard algorithms")
+        {
+            std::ranges::reverse(table);
+            REQUIRE(table.front() == 0x700);
+            std::ranges::sort(table);
+            REQUIRE(std::ranges::is_sorted(packed_view<uint32_be>{table}));
+            std::ranges::fill(table.subview(6), 0xffu);
+
+            THEN("the bytes are changed in place")
+            {
+                REQUIRE(unpack<uint32_be>(bytes, 2 + 4) == 0x100);
+                REQUIRE(unpack<uint32_be>(bytes, 2 + 24) == 0xff);
+                REQUIRE(unpack<uint32_be>(bytes, 2 + 28) == 0xff);
+            }
+        }
+        WHEN("packing a whole range")
+        {
+            pack_range(table.subview(0, 3), std::vector<uint32_t>{1, 2, 3});
+
+            THEN("the values are packed")
+            {
+                REQUIRE(std::ranges::equal(table.subview(0, 4),
+                                           std::vector<uint32_t>{1, 2, 3, 0x300}));
+            }
+        }
+    }
+}